@@ -148,6 +148,7 @@ nv50_crc_get_entries(struct nv50_head *head,
 		drm_crtc_add_crc_entry(crtc, true, crc->frame, &output_crc);
 		crc->frame++;
 		crc->entry_idx++;
+		crc->stats.captured++;
 	}
 }
 
@@ -168,8 +169,10 @@ void nv50_crc_handle_vblank(struct nv50_head *head)
 	 * next vblank, so only report CRCs if the locks we need aren't
 	 * contended to prevent missing an actual vblank event
 	 */
-	if (!spin_trylock(&crc->lock))
+	if (!spin_trylock(&crc->lock)) {
+		atomic_inc(&crc->stats.deferred);
 		return;
+	}
 
 	if (!crc->src)
 		goto out;
@@ -199,6 +202,7 @@ void nv50_crc_handle_vblank(struct nv50_head *head)
 			    "Notifier ctx flip for head-%d finished, lost CRC for frame %llu\n",
 			    head->base.index, crc->frame);
 		crc->frame++;
+		crc->stats.lost++;
 
 		nv50_crc_reset_ctx(ctx);
 		need_reschedule = true;
@@ -337,6 +341,9 @@ void nv50_crc_atomic_start_reporting(struct drm_atomic_state *state)
 		vbl_count = drm_crtc_vblank_count(crtc);
 		crc->frame = vbl_count;
 		crc->src = asyh->crc.src;
+		crc->stats.captured = 0;
+		crc->stats.lost = 0;
+		atomic_set(&crc->stats.deferred, 0);
 		drm_vblank_work_schedule(&crc->flip_work,
 					 vbl_count + crc->flip_threshold,
 					 true);
@@ -704,6 +711,26 @@ static const struct file_operations nv50_crc_flip_threshold_fops = {
 	.release = single_release,
 };
 
+static int
+nv50_crc_debugfs_stats_show(struct seq_file *m, void *data)
+{
+	struct nv50_head *head = m->private;
+	struct nv50_crc *crc = &head->crc;
+	u64 captured, lost;
+
+	spin_lock_irq(&crc->lock);
+	captured = crc->stats.captured;
+	lost = crc->stats.lost;
+	spin_unlock_irq(&crc->lock);
+
+	seq_printf(m, "captured: %llu\n", captured);
+	seq_printf(m, "lost: %llu\n", lost);
+	seq_printf(m, "deferred: %d\n", atomic_read(&crc->stats.deferred));
+	return 0;
+}
+
+DEFINE_SHOW_ATTRIBUTE(nv50_crc_debugfs_stats);
+
 int nv50_head_crc_late_register(struct nv50_head *head)
 {
 	struct drm_crtc *crtc = &head->base.base;
@@ -717,6 +744,8 @@ int nv50_head_crc_late_register(struct nv50_head *head)
 	root = debugfs_create_dir("nv_crc", crtc->debugfs_entry);
 	debugfs_create_file("flip_threshold", 0644, root, head,
 			    &nv50_crc_flip_threshold_fops);
+	debugfs_create_file("stats", 0444, root, head,
+			    &nv50_crc_debugfs_stats_fops);
 
 	return 0;
 }
@@ -71,6 +71,13 @@ struct nv50_crc {
 	short flip_threshold;
 	u8 ctx_idx : 1;
 	bool ctx_changed : 1;
+
+	/* Capture statistics, reset when reporting starts. */
+	struct {
+		u64 captured;
+		u64 lost;
+		atomic_t deferred;
+	} stats;
 };
 
 void nv50_crc_init(struct drm_device *dev);
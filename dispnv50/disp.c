@@ -131,31 +131,76 @@ nv50_dmac_destroy(struct nv50_dmac *dmac)
 }
 
 static void
-nv50_dmac_kick(struct nvif_push *push)
+nv50_dmac_flush(struct nvif_device *device)
 {
-	struct nv50_dmac *dmac = container_of(push, typeof(*dmac), push);
+	/* Push buffer fetches are not coherent with BAR1, we need to ensure
+	 * writes have been flushed right through to VRAM before writing PUT.
+	 */
+	nvif_wr32(&device->object, 0x070000, 0x00000001);
+	nvif_msec(device, 2000,
+		if (!(nvif_rd32(&device->object, 0x070000) & 0x00000002))
+			break;
+	);
+}
 
-	dmac->cur = push->cur - (u32 __iomem *)dmac->push.mem.object.map.ptr;
+/* Write PUT for all work up to dmac->cur, regardless of dmac->defer. */
+static void
+nv50_dmac_submit(struct nv50_dmac *dmac)
+{
 	if (dmac->put != dmac->cur) {
-		/* Push buffer fetches are not coherent with BAR1, we need to ensure
-		 * writes have been flushed right through to VRAM before writing PUT.
-		 */
-		if (dmac->push.mem.type & NVIF_MEM_VRAM) {
-			struct nvif_device *device = dmac->base.device;
-			nvif_wr32(&device->object, 0x070000, 0x00000001);
-			nvif_msec(device, 2000,
-				if (!(nvif_rd32(&device->object, 0x070000) & 0x00000002))
-					break;
-			);
-		}
+		if (dmac->push.mem.type & NVIF_MEM_VRAM)
+			nv50_dmac_flush(dmac->base.device);
 
 		NVIF_WV32(&dmac->base.user, NV507C, PUT, PTR, dmac->cur);
 		dmac->put = dmac->cur;
 	}
 
+	dmac->deferred = false;
+}
+
+static void
+nv50_dmac_kick(struct nvif_push *push)
+{
+	struct nv50_dmac *dmac = container_of(push, typeof(*dmac), push);
+
+	dmac->cur = push->cur - (u32 __iomem *)dmac->push.mem.object.map.ptr;
+	if (dmac->put != dmac->cur) {
+		if (dmac->defer)
+			dmac->deferred = true;
+		else
+			nv50_dmac_submit(dmac);
+	}
+
 	push->bgn = push->cur;
 }
 
+/* Submit work recorded by PUSH_KICK() while dmac->defer was set, with a
+ * single VRAM flush for all of the channels.
+ */
+static void
+nv50_dmac_kick_deferred(struct nv50_dmac **dmac, int nr)
+{
+	bool flush = false;
+	int i;
+
+	for (i = 0; i < nr; i++) {
+		dmac[i]->defer = false;
+		if (dmac[i]->deferred && (dmac[i]->push.mem.type & NVIF_MEM_VRAM))
+			flush = true;
+	}
+
+	if (flush)
+		nv50_dmac_flush(dmac[0]->base.device);
+
+	for (i = 0; i < nr; i++) {
+		if (dmac[i]->deferred) {
+			NVIF_WV32(&dmac[i]->base.user, NV507C, PUT, PTR, dmac[i]->cur);
+			dmac[i]->put = dmac[i]->cur;
+			dmac[i]->deferred = false;
+		}
+	}
+}
+
 static int
 nv50_dmac_free(struct nv50_dmac *dmac)
 {
@@ -175,7 +220,7 @@ nv50_dmac_wind(struct nv50_dmac *dmac)
 	if (get == 0) {
 		/* Corner-case, HW idle, but non-committed work pending. */
 		if (dmac->put == 0)
-			nv50_dmac_kick(&dmac->push);
+			nv50_dmac_submit(dmac);
 
 		if (nvif_msec(dmac->base.device, 2000,
 			if (NVIF_TV32(&dmac->base.user, NV507C, GET, PTR, >, 0))
@@ -198,6 +243,12 @@ nv50_dmac_wait(struct nvif_push *push, u32 size)
 	if (WARN_ON(size > dmac->max))
 		return -EINVAL;
 
+	/* Waiting for space requires that previous work has been submitted,
+	 * even while PUSH_KICK() is being deferred.
+	 */
+	if (dmac->deferred)
+		nv50_dmac_submit(dmac);
+
 	dmac->cur = push->cur - (u32 __iomem *)dmac->push.mem.object.map.ptr;
 	if (dmac->cur + size >= dmac->max) {
 		int ret = nv50_dmac_wind(dmac);
@@ -206,7 +257,8 @@ nv50_dmac_wait(struct nvif_push *push, u32 size)
 
 		push->cur = dmac->push.mem.object.map.ptr;
 		push->cur = push->cur + dmac->cur;
-		nv50_dmac_kick(push);
+		push->bgn = push->cur;
+		nv50_dmac_submit(dmac);
 	}
 
 	if (nvif_msec(dmac->base.device, 2000,
@@ -2146,16 +2198,34 @@ static void
 nv50_disp_atomic_commit_wndw(struct drm_atomic_state *state, u32 *interlock)
 {
 	struct drm_plane_state *new_plane_state;
+	struct nv50_dmac *dmac[32];
 	struct drm_plane *plane;
-	int i;
+	int i, nr = 0;
 
 	for_each_new_plane_in_state(state, plane, new_plane_state, i) {
 		struct nv50_wndw *wndw = nv50_wndw(plane);
 		if (interlock[wndw->interlock.type] & wndw->interlock.data) {
-			if (wndw->func->update)
+			if (wndw->func->update) {
+				if (nr < ARRAY_SIZE(dmac)) {
+					wndw->wndw.defer = true;
+					dmac[nr++] = &wndw->wndw;
+				}
 				wndw->func->update(wndw, interlock);
+			}
 		}
 	}
+
+	if (nr)
+		nv50_dmac_kick_deferred(dmac, nr);
+}
+
+static inline void
+nv50_disp_atomic_commit_stage(s64 *stage, enum nv50_head_stage id, ktime_t *time)
+{
+	ktime_t now = ktime_get();
+
+	stage[id] = ktime_us_delta(now, *time);
+	*time = now;
 }
 
 static void
@@ -2172,14 +2242,19 @@ nv50_disp_atomic_commit_tail(struct drm_atomic_state *state)
 	struct nv50_core *core = disp->core;
 	struct nv50_outp_atom *outp, *outt;
 	u32 interlock[NV50_DISP_INTERLOCK__SIZE] = {};
+	s64 stage[NV50_HEAD_STAGE_NR];
+	ktime_t start, time;
 	int i;
 	bool flushed = false;
 
 	NV_ATOMIC(drm, "commit %d %d\n", atom->lock_core, atom->flush_disable);
+	start = time = ktime_get();
 	nv50_crc_atomic_stop_reporting(state);
 	drm_atomic_helper_wait_for_fences(dev, state, false);
+	nv50_disp_atomic_commit_stage(stage, NV50_HEAD_STAGE_FENCES, &time);
 	drm_atomic_helper_wait_for_dependencies(state);
 	drm_dp_mst_atomic_wait_for_dependencies(state);
+	nv50_disp_atomic_commit_stage(stage, NV50_HEAD_STAGE_DEPS, &time);
 	drm_atomic_helper_update_legacy_modeset_state(dev, state);
 	drm_atomic_helper_calc_timestamping_constants(state);
 
@@ -2247,6 +2322,8 @@ nv50_disp_atomic_commit_tail(struct drm_atomic_state *state)
 		}
 	}
 
+	nv50_disp_atomic_commit_stage(stage, NV50_HEAD_STAGE_DISABLE, &time);
+
 	if (flushed)
 		nv50_crc_atomic_release_notifier_contexts(state);
 	nv50_crc_atomic_init_notifier_contexts(state);
@@ -2348,6 +2425,8 @@ nv50_disp_atomic_commit_tail(struct drm_atomic_state *state)
 		nv50_wndw_flush_set(wndw, interlock, asyw);
 	}
 
+	nv50_disp_atomic_commit_stage(stage, NV50_HEAD_STAGE_ENABLE, &time);
+
 	/* Flush update. */
 	nv50_disp_atomic_commit_wndw(state, interlock);
 
@@ -2364,6 +2443,8 @@ nv50_disp_atomic_commit_tail(struct drm_atomic_state *state)
 	if (atom->lock_core)
 		mutex_unlock(&disp->mutex);
 
+	nv50_disp_atomic_commit_stage(stage, NV50_HEAD_STAGE_FLUSH, &time);
+
 	list_for_each_entry_safe(outp, outt, &atom->outp, head) {
 		list_del(&outp->head);
 		kfree(outp);
@@ -2378,6 +2459,11 @@ nv50_disp_atomic_commit_tail(struct drm_atomic_state *state)
 			NV_ERROR(drm, "%s: timeout\n", plane->name);
 	}
 
+	nv50_disp_atomic_commit_stage(stage, NV50_HEAD_STAGE_ARMED, &time);
+	stage[NV50_HEAD_STAGE_TOTAL] = ktime_us_delta(time, start);
+	for_each_new_crtc_in_state(state, crtc, new_crtc_state, i)
+		nv50_head_stats_add(nv50_head(crtc), stage);
+
 	for_each_new_crtc_in_state(state, crtc, new_crtc_state, i) {
 		if (new_crtc_state->event) {
 			unsigned long flags;
@@ -2782,10 +2868,20 @@ nv50_display_init(struct drm_device *dev, bool resume, bool runtime)
 {
 	struct nv50_core *core = nv50_disp(dev)->core;
 	struct drm_encoder *encoder;
+	struct drm_plane *plane;
+	struct drm_crtc *crtc;
 
 	if (resume || runtime)
 		core->func->init(core);
 
+	/* LUT contents in VRAM don't survive suspend. */
+	if (resume || runtime) {
+		drm_for_each_crtc(crtc, dev)
+			nv50_lut_invalidate(&nv50_head(crtc)->olut);
+		drm_for_each_plane(plane, dev)
+			nv50_lut_invalidate(&nv50_wndw(plane)->ilut);
+	}
+
 	list_for_each_entry(encoder, &dev->mode_config.encoder_list, head) {
 		if (encoder->encoder_type != DRM_MODE_ENCODER_DPMST) {
 			struct nouveau_encoder *nv_encoder =
@@ -70,6 +70,12 @@ struct nv50_dmac {
 	u32 cur;
 	u32 put;
 	u32 max;
+
+	/* PUSH_KICK() only records the new PUT, nv50_dmac_kick_deferred()
+	 * submits it later, so several channels can share a VRAM flush.
+	 */
+	bool defer;
+	bool deferred;
 };
 
 struct nv50_outp_atom {
@@ -34,6 +34,8 @@
 #include <drm/drm_atomic_helper.h>
 #include <drm/drm_edid.h>
 #include <drm/drm_vblank.h>
+
+#include <linux/debugfs.h>
 #include "nouveau_connector.h"
 
 void
@@ -500,10 +502,57 @@ nv50_head_reset(struct drm_crtc *crtc)
 	__drm_atomic_helper_crtc_reset(crtc, &asyh->state);
 }
 
+void
+nv50_head_stats_add(struct nv50_head *head, const s64 *us)
+{
+	int i;
+
+	for (i = 0; i < NV50_HEAD_STAGE_NR; i++) {
+		int bucket = us[i] > 0 ? fls64(us[i]) : 0;
+
+		head->stats.hist[i][min(bucket, NV50_HEAD_STATS_BUCKETS - 1)]++;
+		head->stats.max[i] = max(head->stats.max[i], us[i]);
+	}
+}
+
+static int
+nv50_head_stats_show(struct seq_file *m, void *data)
+{
+	static const char *const name[NV50_HEAD_STAGE_NR] = {
+		[NV50_HEAD_STAGE_FENCES ] = "fences",
+		[NV50_HEAD_STAGE_DEPS   ] = "deps",
+		[NV50_HEAD_STAGE_DISABLE] = "disable",
+		[NV50_HEAD_STAGE_ENABLE ] = "enable",
+		[NV50_HEAD_STAGE_FLUSH  ] = "flush",
+		[NV50_HEAD_STAGE_ARMED  ] = "armed",
+		[NV50_HEAD_STAGE_TOTAL  ] = "total",
+	};
+	struct nv50_head *head = m->private;
+	int i, j;
+
+	seq_puts(m, "stage   max(us)  histogram (<1us, <2us, <4us, ...)\n");
+	for (i = 0; i < NV50_HEAD_STAGE_NR; i++) {
+		seq_printf(m, "%-7s %8lld ", name[i], head->stats.max[i]);
+		for (j = 0; j < NV50_HEAD_STATS_BUCKETS; j++)
+			seq_printf(m, " %u", head->stats.hist[i][j]);
+		seq_putc(m, '\n');
+	}
+
+	return 0;
+}
+
+DEFINE_SHOW_ATTRIBUTE(nv50_head_stats);
+
 static int
 nv50_head_late_register(struct drm_crtc *crtc)
 {
-	return nv50_head_crc_late_register(nv50_head(crtc));
+	struct nv50_head *head = nv50_head(crtc);
+
+	if (crtc->debugfs_entry)
+		debugfs_create_file("nv_commit_stats", 0444, crtc->debugfs_entry,
+				    head, &nv50_head_stats_fops);
+
+	return nv50_head_crc_late_register(head);
 }
 
 static void
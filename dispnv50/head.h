@@ -11,15 +11,35 @@
 #include "nouveau_crtc.h"
 #include "nouveau_encoder.h"
 
+enum nv50_head_stage {
+	NV50_HEAD_STAGE_FENCES,
+	NV50_HEAD_STAGE_DEPS,
+	NV50_HEAD_STAGE_DISABLE,
+	NV50_HEAD_STAGE_ENABLE,
+	NV50_HEAD_STAGE_FLUSH,
+	NV50_HEAD_STAGE_ARMED,
+	NV50_HEAD_STAGE_TOTAL,
+	NV50_HEAD_STAGE_NR
+};
+
+#define NV50_HEAD_STATS_BUCKETS 20
+
 struct nv50_head {
 	const struct nv50_head_func *func;
 	struct nouveau_crtc base;
 	struct nv50_crc crc;
 	struct nv50_lut olut;
 	struct nv50_msto *msto;
+
+	/* Atomic commit latency, per-stage log2(us) histograms. */
+	struct {
+		u32 hist[NV50_HEAD_STAGE_NR][NV50_HEAD_STATS_BUCKETS];
+		s64 max[NV50_HEAD_STAGE_NR];
+	} stats;
 };
 
 struct nv50_head *nv50_head_create(struct drm_device *, int index);
+void nv50_head_stats_add(struct nv50_head *, const s64 *us);
 void nv50_head_flush_set(struct nv50_head *head, struct nv50_head_atom *asyh);
 void nv50_head_flush_set_wndw(struct nv50_head *head, struct nv50_head_atom *asyh);
 void nv50_head_flush_clr(struct nv50_head *head,
@@ -28,6 +28,8 @@
 
 #include <nvif/class.h>
 
+#include <linux/jhash.h>
+
 u32
 nv50_lut_load(struct nv50_lut *lut, int buffer, struct drm_property_blob *blob,
 	      void (*load)(struct drm_color_lut *, int, void __iomem *))
@@ -35,8 +37,17 @@ nv50_lut_load(struct nv50_lut *lut, int buffer, struct drm_property_blob *blob,
 	struct drm_color_lut *in = blob ? blob->data : NULL;
 	void __iomem *mem = lut->mem[buffer].object.map.ptr;
 	const u32 addr = lut->mem[buffer].addr;
+	const int size = blob ? drm_color_lut_size(blob) : 1024;
+	const u32 hash = blob ? jhash(blob->data, blob->length, 0) : 0;
+	typeof(lut->cache[0]) *cache = &lut->cache[buffer];
 	int i;
 
+	if (cache->valid && cache->blob == (blob ? blob->base.id : 0) &&
+	    cache->hash == hash && cache->size == size && cache->load == load)
+		return addr;
+
+	cache->valid = false;
+
 	if (!in) {
 		in = kvmalloc_array(1024, sizeof(*in), GFP_KERNEL);
 		if (!WARN_ON(!in)) {
@@ -47,14 +58,29 @@ nv50_lut_load(struct nv50_lut *lut, int buffer, struct drm_property_blob *blob,
 			}
 			load(in, 1024, mem);
 			kvfree(in);
+		} else {
+			return addr;
 		}
 	} else {
-		load(in, drm_color_lut_size(blob), mem);
+		load(in, size, mem);
 	}
 
+	cache->valid = true;
+	cache->blob = blob ? blob->base.id : 0;
+	cache->hash = hash;
+	cache->size = size;
+	cache->load = load;
 	return addr;
 }
 
+void
+nv50_lut_invalidate(struct nv50_lut *lut)
+{
+	int i;
+	for (i = 0; i < ARRAY_SIZE(lut->cache); i++)
+		lut->cache[i].valid = false;
+}
+
 void
 nv50_lut_fini(struct nv50_lut *lut)
 {
@@ -75,5 +101,6 @@ nv50_lut_init(struct nv50_disp *disp, struct nvif_mmu *mmu,
 		if (ret)
 			return ret;
 	}
+	nv50_lut_invalidate(lut);
 	return 0;
 }
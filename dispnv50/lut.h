@@ -7,10 +7,22 @@ struct nv50_disp;
 
 struct nv50_lut {
 	struct nvif_mem mem[2];
+
+	/* What each buffer currently holds, so unchanged tables needn't be
+	 * written again.  blob is 0 for the identity table.
+	 */
+	struct {
+		bool valid;
+		u32 blob;
+		u32 hash;
+		int size;
+		void (*load)(struct drm_color_lut *, int size, void __iomem *);
+	} cache[2];
 };
 
 int nv50_lut_init(struct nv50_disp *, struct nvif_mmu *, struct nv50_lut *);
 void nv50_lut_fini(struct nv50_lut *);
+void nv50_lut_invalidate(struct nv50_lut *);
 u32 nv50_lut_load(struct nv50_lut *, int buffer, struct drm_property_blob *,
 		  void (*)(struct drm_color_lut *, int size, void __iomem *));
 #endif
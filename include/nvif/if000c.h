@@ -77,12 +77,14 @@ struct nvif_vmm_raw_v0 {
 #define NVIF_VMM_RAW_V0_MAP	0x2
 #define NVIF_VMM_RAW_V0_UNMAP	0x3
 #define NVIF_VMM_RAW_V0_SPARSE	0x4
+#define NVIF_VMM_RAW_V0_FLUSH	0x5
 	__u8  op;
 	__u8  sparse;
 	__u8  ref;
 	__u8  shift;
 	__u32 argc;
-	__u8  pad01[7];
+	__u8  defer;
+	__u8  pad02[6];
 	__u64 addr;
 	__u64 size;
 	__u64 offset;
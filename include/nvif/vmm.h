@@ -50,8 +50,10 @@ int nvif_vmm_unmap(struct nvif_vmm *, u64);
 int nvif_vmm_raw_get(struct nvif_vmm *vmm, u64 addr, u64 size, u8 shift);
 int nvif_vmm_raw_put(struct nvif_vmm *vmm, u64 addr, u64 size, u8 shift);
 int nvif_vmm_raw_map(struct nvif_vmm *vmm, u64 addr, u64 size, u8 shift,
-		     void *argv, u32 argc, struct nvif_mem *mem, u64 offset);
+		     void *argv, u32 argc, struct nvif_mem *mem, u64 offset,
+		     bool defer);
 int nvif_vmm_raw_unmap(struct nvif_vmm *vmm, u64 addr, u64 size,
-		       u8 shift, bool sparse);
+		       u8 shift, bool sparse, bool defer);
 int nvif_vmm_raw_sparse(struct nvif_vmm *vmm, u64 addr, u64 size, bool ref);
+int nvif_vmm_raw_flush(struct nvif_vmm *vmm);
 #endif
@@ -72,10 +72,21 @@ struct nvkm_device {
 		bool armed;
 		bool legacy_done;
 	} intr;
+
+	struct {
+		struct mutex mutex;
+		struct list_head list;
+		struct list_head log;
+		struct list_head images;
+	} fw;
 };
 
 struct nvkm_subdev *nvkm_device_subdev(struct nvkm_device *, int type, int inst);
 struct nvkm_engine *nvkm_device_engine(struct nvkm_device *, int type, int inst);
+int nvkm_device_time_foreach(struct nvkm_device *,
+			     int (*func)(void *priv, const char *name,
+					 s64 init, s64 fini),
+			     void *priv);
 
 struct nvkm_device_func {
 	struct nvkm_device_pci *(*pci)(struct nvkm_device *);
@@ -26,6 +26,7 @@ struct nvkm_engine_func {
 	void (*intr)(struct nvkm_engine *);
 	void (*tile)(struct nvkm_engine *, int region, struct nvkm_fb_tile *);
 	bool (*chsw_load)(struct nvkm_engine *);
+	bool async; /* See nvkm_subdev_func.async. */
 
 	struct {
 		int (*sclass)(struct nvkm_oclass *, int index,
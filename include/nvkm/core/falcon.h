@@ -36,6 +36,11 @@ struct nvkm_falcon_func_dma {
 		    enum nvkm_falcon_mem, bool sec, u32 *cmd);
 	void (*xfer)(struct nvkm_falcon *, u32 mem_base, u32 dma_base, u32 cmd);
 	bool (*done)(struct nvkm_falcon *);
+	/* Optional: transfer queue can't accept another request.  When
+	 * provided, transfers are queued back-to-back and completion is
+	 * only waited on once all have been submitted.
+	 */
+	bool (*full)(struct nvkm_falcon *);
 };
 
 int nvkm_falcon_ctor(const struct nvkm_falcon_func *, struct nvkm_subdev *owner,
@@ -204,6 +209,9 @@ void nvkm_falcon_cmdq_fini(struct nvkm_falcon_cmdq *);
 int nvkm_falcon_cmdq_send(struct nvkm_falcon_cmdq *, struct nvfw_falcon_cmd *,
 			  nvkm_falcon_qmgr_callback, void *priv,
 			  unsigned long timeout_jiffies);
+int nvkm_falcon_cmdq_send_many(struct nvkm_falcon_cmdq *, struct nvfw_falcon_cmd **, int nr,
+			       nvkm_falcon_qmgr_callback, void *priv,
+			       unsigned long timeout_jiffies);
 
 struct nvkm_falcon_msgq;
 int nvkm_falcon_msgq_new(struct nvkm_falcon_qmgr *, const char *name,
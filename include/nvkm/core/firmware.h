@@ -15,6 +15,7 @@ struct nvkm_firmware {
 	} *func;
 	const char *name;
 	struct nvkm_device *device;
+	struct list_head head;
 
 	int len;
 	u8 *img;
@@ -36,6 +37,16 @@ void nvkm_firmware_dtor(struct nvkm_firmware *);
 int nvkm_firmware_get(const struct nvkm_subdev *, const char *fwname, int ver,
 		      const struct firmware **);
 void nvkm_firmware_put(const struct firmware *);
+void nvkm_firmware_prefetch(struct nvkm_device *);
+int nvkm_firmware_log_foreach(struct nvkm_device *,
+			      int (*func)(void *priv, const char *path, size_t size,
+					  ktime_t loaded, u32 load_us),
+			      void *priv);
+int nvkm_firmware_image_foreach(struct nvkm_device *,
+				int (*func)(void *priv, const char *name,
+					    const void *data, size_t size),
+				void *priv);
+void nvkm_firmware_cache_fini(struct nvkm_device *);
 
 int nvkm_firmware_load_blob(const struct nvkm_subdev *subdev, const char *path,
 			    const char *name, int ver, struct nvkm_blob *);
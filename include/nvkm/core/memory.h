@@ -44,6 +44,9 @@ struct nvkm_memory_func {
 struct nvkm_memory_ptrs {
 	u32 (*rd32)(struct nvkm_memory *, u64 offset);
 	void (*wr32)(struct nvkm_memory *, u64 offset, u32 data);
+	/* Optional, for accessors where per-word access is expensive. */
+	void (*rd)(struct nvkm_memory *, u64 offset, void *data, u32 size);
+	void (*wr)(struct nvkm_memory *, u64 offset, const void *data, u32 size);
 };
 
 void nvkm_memory_ctor(const struct nvkm_memory_func *, struct nvkm_memory *);
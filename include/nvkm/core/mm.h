@@ -38,6 +38,7 @@ int  nvkm_mm_head(struct nvkm_mm *, u8 heap, u8 type, u32 size_max,
 int  nvkm_mm_tail(struct nvkm_mm *, u8 heap, u8 type, u32 size_max,
 		  u32 size_min, u32 align, struct nvkm_mm_node **);
 void nvkm_mm_free(struct nvkm_mm *, struct nvkm_mm_node **);
+struct nvkm_mm_node *nvkm_mm_split(struct nvkm_mm *, struct nvkm_mm_node *, u32 size);
 void nvkm_mm_dump(struct nvkm_mm *, const char *);
 
 static inline u32
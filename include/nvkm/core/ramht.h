@@ -16,6 +16,8 @@ struct nvkm_ramht {
 	struct nvkm_gpuobj *gpuobj;
 	int size;
 	int bits;
+	int used;
+	int probe_max;
 	struct nvkm_ramht_data data[];
 };
 
@@ -32,6 +32,13 @@ struct nvkm_subdev {
 	struct list_head head;
 	void **pself;
 	bool oneinit;
+
+	struct {
+		s64 init; /* Duration of most recent init, in us. */
+		s64 fini; /* Duration of most recent fini/suspend, in us. */
+	} time;
+
+	int async_ret; /* Result of init/fini when run asynchronously. */
 };
 
 struct nvkm_subdev_func {
@@ -42,6 +49,12 @@ struct nvkm_subdev_func {
 	int (*init)(struct nvkm_subdev *);
 	int (*fini)(struct nvkm_subdev *, bool suspend);
 	void (*intr)(struct nvkm_subdev *);
+
+	/* init/fini depend only on subdevs earlier in the device's list that
+	 * aren't async themselves, and may run concurrently with those that
+	 * are.
+	 */
+	bool async;
 };
 
 extern const char *nvkm_subdev_type[NVKM_SUBDEV_NR];
@@ -32,4 +32,5 @@ u32 nvbios_rd32(struct nvkm_bios *, u32 addr);
 void *nvbios_pointer(struct nvkm_bios *, u32 addr);
 
 int nvkm_bios_new(struct nvkm_device *, enum nvkm_subdev_type, int, struct nvkm_bios **);
+void nvkm_bios_cache_fini(void);
 #endif
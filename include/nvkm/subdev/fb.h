@@ -144,6 +144,11 @@ struct nvkm_ram {
 	u64 stolen;
 	struct mutex mutex;
 
+	struct {
+		struct nvkm_ram_slab_pcp __percpu *pcp;
+		struct list_head list; /* Partially used, protected by mutex. */
+	} slab;
+
 	int ranks;
 	int parts;
 	int part_mask;
@@ -8,6 +8,7 @@ struct nvkm_mc {
 	struct nvkm_subdev subdev;
 
 	struct nvkm_intr intr;
+	spinlock_t lock; /* Serialises PMC_ENABLE updates. */
 };
 
 void nvkm_mc_enable(struct nvkm_device *, enum nvkm_subdev_type, int);
@@ -19,6 +19,7 @@ struct nvkm_vma {
 	bool busy:1; /* Region busy (for temporarily preventing user access). */
 	bool mapped:1; /* Region contains valid pages. */
 	bool no_comp:1; /* Force no memory compression. */
+	bool no_flush:1; /* Defer TLB invalidate to nvkm_vmm_raw_flush(). */
 	struct nvkm_memory *memory; /* Memory currently mapped into VMA. */
 	struct nvkm_tags *tags; /* Compression tag reference. */
 };
@@ -48,6 +49,7 @@ struct nvkm_vmm {
 			u64 size;
 		} n;
 		bool raw;
+		int flush; /* Deferred TLB invalidate (protected by mutex.map). */
 	} managed;
 
 	struct nvkm_vmm_pt *pd;
@@ -4,7 +4,7 @@
 #include <core/subdev.h>
 
 struct nvkm_alarm {
-	struct list_head head;
+	struct rb_node node;
 	struct list_head exec;
 	u64 timestamp;
 	void (*func)(struct nvkm_alarm *);
@@ -13,7 +13,7 @@ struct nvkm_alarm {
 static inline void
 nvkm_alarm_init(struct nvkm_alarm *alarm, void (*func)(struct nvkm_alarm *))
 {
-	INIT_LIST_HEAD(&alarm->head);
+	RB_CLEAR_NODE(&alarm->node);
 	alarm->func = func;
 }
 
@@ -21,7 +21,7 @@ struct nvkm_timer {
 	const struct nvkm_timer_func *func;
 	struct nvkm_subdev subdev;
 
-	struct list_head alarms;
+	struct rb_root_cached alarms;
 	spinlock_t lock;
 };
 
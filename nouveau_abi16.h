@@ -27,6 +27,9 @@ struct nouveau_abi16_chan {
 	struct nouveau_vma *ntfy_vma;
 	struct nvkm_mm heap;
 	struct nouveau_sched *sched;
+
+	/* Previous pushbuf on this channel needed relocations applied. */
+	bool relocs;
 };
 
 struct nouveau_abi16 {
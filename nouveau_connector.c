@@ -556,6 +556,7 @@ nouveau_connector_set_edid(struct nouveau_connector *nv_connector,
 		drm_connector_update_edid_property(&nv_connector->base, edid);
 		kfree(old_edid);
 		nv_connector->edid = edid;
+		nv_connector->edid_cached = false;
 	}
 }
 
@@ -592,6 +593,14 @@ nouveau_connector_detect(struct drm_connector *connector, bool force)
 	if (nv_encoder) {
 		struct edid *new_edid = NULL;
 
+		/* Sink is still present, and there's been no hotplug or DP IRQ
+		 * since we last read its EDID, so there's no need to fetch it
+		 * over DDC/AUX again.
+		 */
+		if (READ_ONCE(nv_connector->edid_cached) && nv_connector->edid) {
+			NV_DEBUG(drm, "%s: using cached EDID\n", connector->name);
+			new_edid = nv_connector->edid;
+		} else
 		if (nv_encoder->i2c) {
 			if ((vga_switcheroo_handler_flags() & VGA_SWITCHEROO_CAN_SWITCH_DDC) &&
 			    nv_connector->type == DCB_CONNECTOR_LVDS)
@@ -611,6 +620,10 @@ nouveau_connector_detect(struct drm_connector *connector, bool force)
 			goto detect_analog;
 		}
 
+		/* Only connectors with HPD get told when the sink changes. */
+		if (connector->polled & DRM_CONNECTOR_POLL_HPD)
+			WRITE_ONCE(nv_connector->edid_cached, true);
+
 		/* Override encoder type for DVI-I based on whether EDID
 		 * says the display is digital or analog, both use the
 		 * same i2c channel so the value returned from ddc_detect
@@ -1192,6 +1205,8 @@ nouveau_connector_hpd(struct nouveau_connector *nv_connector, u64 bits)
 	u32 mask = drm_connector_mask(&nv_connector->base);
 	unsigned long flags;
 
+	WRITE_ONCE(nv_connector->edid_cached, false);
+
 	spin_lock_irqsave(&drm->hpd_lock, flags);
 	if (!(drm->hpd_pending & mask)) {
 		nv_connector->hpd_pending |= bits;
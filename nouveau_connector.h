@@ -138,6 +138,7 @@ struct nouveau_connector {
 
 	struct nouveau_encoder *detected_encoder;
 	struct edid *edid;
+	bool edid_cached;
 	struct drm_display_mode *native_mode;
 #ifdef CONFIG_DRM_NOUVEAU_BACKLIGHT
 	struct nouveau_backlight *backlight;
@@ -31,21 +31,141 @@
 #include <linux/debugfs.h>
 #include <nvif/class.h>
 #include <nvif/if0001.h>
+#include <core/firmware.h>
 #include "nouveau_debugfs.h"
 #include "nouveau_drv.h"
 
+static ssize_t
+nouveau_debugfs_vbios_read(struct file *file, char __user *ubuf,
+			   size_t len, loff_t *offp)
+{
+	struct nouveau_drm *drm = file->private_data;
+
+	return simple_read_from_buffer(ubuf, len, offp, drm->vbios.data,
+				       drm->vbios.length);
+}
+
+static const struct file_operations nouveau_vbios_fops = {
+	.owner = THIS_MODULE,
+	.open = simple_open,
+	.read = nouveau_debugfs_vbios_read,
+	.llseek = default_llseek,
+};
+
+/* firmware_images/ has a read-only file for each firmware image held by
+ * nvkm.  nvkm may release an image at any time, so it's looked up by name
+ * on every read.
+ */
+struct nouveau_debugfs_fw {
+	struct nouveau_drm *drm;
+	struct dentry *dir;
+	const char *name;
+	char __user *ubuf;
+	size_t len;
+	loff_t *offp;
+	ssize_t ret;
+};
+
+static void
+nouveau_debugfs_firmware_name(char *name, size_t size, const char *src)
+{
+	strscpy(name, src, size);
+	strreplace(name, '/', '_');
+}
+
+static int
+nouveau_debugfs_firmware_read_one(void *priv, const char *name,
+				  const void *data, size_t size)
+{
+	struct nouveau_debugfs_fw *dfw = priv;
+	char fname[64];
+
+	nouveau_debugfs_firmware_name(fname, sizeof(fname), name);
+	if (strcmp(fname, dfw->name))
+		return 0;
+
+	dfw->ret = simple_read_from_buffer(dfw->ubuf, dfw->len, dfw->offp,
+					   data, size);
+	return 1;
+}
+
+static ssize_t
+nouveau_debugfs_firmware_read(struct file *file, char __user *ubuf,
+			      size_t len, loff_t *offp)
+{
+	struct nouveau_drm *drm = file->private_data;
+	struct nouveau_debugfs_fw dfw = {
+		.name = file->f_path.dentry->d_name.name,
+		.ubuf = ubuf,
+		.len = len,
+		.offp = offp,
+		.ret = -ENOENT,
+	};
+
+	nvkm_firmware_image_foreach(drm->nvkm, nouveau_debugfs_firmware_read_one, &dfw);
+	return dfw.ret;
+}
+
+static const struct file_operations nouveau_firmware_fops = {
+	.owner = THIS_MODULE,
+	.open = simple_open,
+	.read = nouveau_debugfs_firmware_read,
+	.llseek = default_llseek,
+};
+
+static int
+nouveau_debugfs_firmware_add(void *priv, const char *name,
+			     const void *data, size_t size)
+{
+	struct nouveau_debugfs_fw *dfw = priv;
+	char fname[64];
+
+	nouveau_debugfs_firmware_name(fname, sizeof(fname), name);
+	debugfs_create_file_size(fname, S_IRUGO, dfw->dir, dfw->drm,
+				 &nouveau_firmware_fops, size);
+	return 0;
+}
+
+static int
+nouveau_debugfs_firmware_show(void *priv, const char *path, size_t size,
+			      ktime_t loaded, u32 load_us)
+{
+	struct seq_file *m = priv;
+
+	seq_printf(m, "%-48s %9zu %12lld %9u\n", path, size,
+		   ktime_to_us(loaded), load_us);
+	return 0;
+}
+
 static int
-nouveau_debugfs_vbios_image(struct seq_file *m, void *data)
+nouveau_debugfs_firmware(struct seq_file *m, void *data)
 {
 	struct drm_info_node *node = (struct drm_info_node *) m->private;
 	struct nouveau_drm *drm = nouveau_drm(node->minor->dev);
-	int i;
 
-	for (i = 0; i < drm->vbios.length; i++)
-		seq_printf(m, "%c", drm->vbios.data[i]);
+	seq_printf(m, "%-48s %9s %12s %9s\n", "path", "size", "loaded(us)", "took(us)");
+	return nvkm_firmware_log_foreach(drm->nvkm, nouveau_debugfs_firmware_show, m);
+}
+
+static int
+nouveau_debugfs_subdev_time_show(void *priv, const char *name, s64 init, s64 fini)
+{
+	struct seq_file *m = priv;
+
+	seq_printf(m, "%-16s %9lld %9lld\n", name, init, fini);
 	return 0;
 }
 
+static int
+nouveau_debugfs_subdev_time(struct seq_file *m, void *data)
+{
+	struct drm_info_node *node = (struct drm_info_node *) m->private;
+	struct nouveau_drm *drm = nouveau_drm(node->minor->dev);
+
+	seq_printf(m, "%-16s %9s %9s\n", "subdev", "init(us)", "fini(us)");
+	return nvkm_device_time_foreach(drm->nvkm, nouveau_debugfs_subdev_time_show, m);
+}
+
 static int
 nouveau_debugfs_strap_peek(struct seq_file *m, void *data)
 {
@@ -250,8 +370,9 @@ static const struct file_operations nouveau_pstate_fops = {
 };
 
 static struct drm_info_list nouveau_debugfs_list[] = {
-	{ "vbios.rom",  nouveau_debugfs_vbios_image, 0, NULL },
 	{ "strap_peek", nouveau_debugfs_strap_peek, 0, NULL },
+	{ "firmware",   nouveau_debugfs_firmware, 0, NULL },
+	{ "subdev_time", nouveau_debugfs_subdev_time, 0, NULL },
 	DRM_DEBUGFS_GPUVA_INFO(nouveau_debugfs_gpuva, NULL),
 };
 #define NOUVEAU_DEBUGFS_ENTRIES ARRAY_SIZE(nouveau_debugfs_list)
@@ -267,7 +388,7 @@ void
 nouveau_drm_debugfs_init(struct drm_minor *minor)
 {
 	struct nouveau_drm *drm = nouveau_drm(minor->dev);
-	struct dentry *dentry;
+	struct nouveau_debugfs_fw dfw = {};
 	int i;
 
 	for (i = 0; i < ARRAY_SIZE(nouveau_debugfs_files); i++) {
@@ -284,12 +405,15 @@ nouveau_drm_debugfs_init(struct drm_minor *minor)
 	/* Set the size of the vbios since we know it, and it's confusing to
 	 * userspace if it wants to seek() but the file has a length of 0
 	 */
-	dentry = debugfs_lookup("vbios.rom", minor->debugfs_root);
-	if (!dentry)
-		return;
+	debugfs_create_file_size("vbios.rom", S_IRUGO, minor->debugfs_root, drm,
+				 &nouveau_vbios_fops, drm->vbios.length);
 
-	d_inode(dentry)->i_size = drm->vbios.length;
-	dput(dentry);
+	/* Most images are created during the device's one-time init, any
+	 * created later (eg. by an engine on first use) won't appear here.
+	 */
+	dfw.drm = drm;
+	dfw.dir = debugfs_create_dir("firmware_images", minor->debugfs_root);
+	nvkm_firmware_image_foreach(drm->nvkm, nouveau_debugfs_firmware_add, &dfw);
 }
 
 int
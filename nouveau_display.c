@@ -467,6 +467,9 @@ nouveau_display_hpd_work(struct work_struct *work)
 				continue;
 		}
 
+		/* Also covers resume, where the sink may have changed unseen. */
+		WRITE_ONCE(nv_connector->edid_cached, false);
+
 		connector->status = drm_helper_probe_detect(connector, NULL, false);
 		if (old_epoch_counter == connector->epoch_counter)
 			continue;
@@ -40,6 +40,7 @@
 #include <linux/hmm.h>
 #include <linux/memremap.h>
 #include <linux/migrate.h>
+#include <linux/local_lock.h>
 
 /*
  * FIXME: this is ugly right now we are using TTM to allocate vram and we pin
@@ -51,6 +52,13 @@
 #define DMEM_CHUNK_SIZE (2UL << 20)
 #define DMEM_CHUNK_NPAGES (DMEM_CHUNK_SIZE >> PAGE_SHIFT)
 
+/*
+ * Free device pages are cached per-CPU, and moved to/from the global free
+ * list in batches, to keep allocation off the global lock.
+ */
+#define DMEM_PCP_NPAGES 64
+#define DMEM_PCP_BATCH (DMEM_PCP_NPAGES / 2)
+
 enum nouveau_aper {
 	NOUVEAU_APER_VIRT,
 	NOUVEAU_APER_VRAM,
@@ -77,6 +85,12 @@ struct nouveau_dmem_migrate {
 	struct nouveau_channel *chan;
 };
 
+struct nouveau_dmem_pcp {
+	local_lock_t lock;
+	unsigned int nr;
+	struct page *pages[DMEM_PCP_NPAGES];
+};
+
 struct nouveau_dmem {
 	struct nouveau_drm *drm;
 	struct nouveau_dmem_migrate migrate;
@@ -84,6 +98,7 @@ struct nouveau_dmem {
 	struct mutex mutex;
 	struct page *free_pages;
 	spinlock_t lock;
+	struct nouveau_dmem_pcp __percpu *pcp;
 };
 
 static struct nouveau_dmem_chunk *nouveau_page_to_chunk(struct page *page)
@@ -107,24 +122,73 @@ unsigned long nouveau_dmem_page_addr(struct page *page)
 	return chunk->bo->offset + off;
 }
 
-static void nouveau_dmem_page_free(struct page *page)
+/*
+ * Pages held in the per-CPU caches are accounted as allocated from their
+ * chunk, chunk->callocated only changes when pages move to or from the
+ * global free list.
+ */
+static void
+nouveau_dmem_pcp_drain(struct nouveau_dmem *dmem,
+		       struct nouveau_dmem_pcp *pcp, unsigned int count)
 {
-	struct nouveau_dmem_chunk *chunk = nouveau_page_to_chunk(page);
-	struct nouveau_dmem *dmem = chunk->drm->dmem;
+	struct nouveau_dmem_chunk *chunk;
+	struct page *page;
 
 	spin_lock(&dmem->lock);
-	page->zone_device_data = dmem->free_pages;
-	dmem->free_pages = page;
+	while (count-- && pcp->nr) {
+		page = pcp->pages[--pcp->nr];
+		page->zone_device_data = dmem->free_pages;
+		dmem->free_pages = page;
 
-	WARN_ON(!chunk->callocated);
-	chunk->callocated--;
-	/*
-	 * FIXME when chunk->callocated reach 0 we should add the chunk to
-	 * a reclaim list so that it can be freed in case of memory pressure.
-	 */
+		chunk = nouveau_page_to_chunk(page);
+		WARN_ON(!chunk->callocated);
+		chunk->callocated--;
+		/*
+		 * FIXME when chunk->callocated reach 0 we should add the chunk
+		 * to a reclaim list so that it can be freed in case of memory
+		 * pressure.
+		 */
+	}
 	spin_unlock(&dmem->lock);
 }
 
+static void
+nouveau_dmem_pcp_refill(struct nouveau_dmem *dmem,
+			struct nouveau_dmem_pcp *pcp)
+{
+	struct nouveau_dmem_chunk *chunk;
+	struct page *page;
+	unsigned int i, j;
+
+	spin_lock(&dmem->lock);
+	while (pcp->nr < DMEM_PCP_BATCH && dmem->free_pages) {
+		page = dmem->free_pages;
+		dmem->free_pages = page->zone_device_data;
+		chunk = nouveau_page_to_chunk(page);
+		chunk->callocated++;
+		pcp->pages[pcp->nr++] = page;
+	}
+	spin_unlock(&dmem->lock);
+
+	/* Hand pages out in the same order as the global free list. */
+	for (i = 0, j = pcp->nr - 1; pcp->nr && i < j; i++, j--)
+		swap(pcp->pages[i], pcp->pages[j]);
+}
+
+static void nouveau_dmem_page_free(struct page *page)
+{
+	struct nouveau_dmem_chunk *chunk = nouveau_page_to_chunk(page);
+	struct nouveau_dmem *dmem = chunk->drm->dmem;
+	struct nouveau_dmem_pcp *pcp;
+
+	local_lock(&dmem->pcp->lock);
+	pcp = this_cpu_ptr(dmem->pcp);
+	if (pcp->nr == ARRAY_SIZE(pcp->pages))
+		nouveau_dmem_pcp_drain(dmem, pcp, DMEM_PCP_BATCH);
+	pcp->pages[pcp->nr++] = page;
+	local_unlock(&dmem->pcp->lock);
+}
+
 static void nouveau_dmem_fence_done(struct nouveau_fence **fence)
 {
 	if (fence) {
@@ -275,10 +339,15 @@ nouveau_dmem_chunk_alloc(struct nouveau_drm *drm, struct page **ppage)
 	list_add(&chunk->list, &drm->dmem->chunks);
 	mutex_unlock(&drm->dmem->mutex);
 
+	/*
+	 * Thread the free list in ascending address order, so that pages
+	 * allocated back-to-back are physically contiguous in VRAM and can
+	 * be migrated with a single copy.
+	 */
 	pfn_first = chunk->pagemap.range.start >> PAGE_SHIFT;
-	page = pfn_to_page(pfn_first);
+	page = pfn_to_page(pfn_first + DMEM_CHUNK_NPAGES - 1);
 	spin_lock(&drm->dmem->lock);
-	for (i = 0; i < DMEM_CHUNK_NPAGES - 1; ++i, ++page) {
+	for (i = 0; i < DMEM_CHUNK_NPAGES - 1; ++i, --page) {
 		page->zone_device_data = drm->dmem->free_pages;
 		drm->dmem->free_pages = page;
 	}
@@ -306,19 +375,20 @@ out:
 static struct page *
 nouveau_dmem_page_alloc_locked(struct nouveau_drm *drm)
 {
-	struct nouveau_dmem_chunk *chunk;
+	struct nouveau_dmem *dmem = drm->dmem;
+	struct nouveau_dmem_pcp *pcp;
 	struct page *page = NULL;
 	int ret;
 
-	spin_lock(&drm->dmem->lock);
-	if (drm->dmem->free_pages) {
-		page = drm->dmem->free_pages;
-		drm->dmem->free_pages = page->zone_device_data;
-		chunk = nouveau_page_to_chunk(page);
-		chunk->callocated++;
-		spin_unlock(&drm->dmem->lock);
-	} else {
-		spin_unlock(&drm->dmem->lock);
+	local_lock(&dmem->pcp->lock);
+	pcp = this_cpu_ptr(dmem->pcp);
+	if (!pcp->nr)
+		nouveau_dmem_pcp_refill(dmem, pcp);
+	if (pcp->nr)
+		page = pcp->pages[--pcp->nr];
+	local_unlock(&dmem->pcp->lock);
+
+	if (!page) {
 		ret = nouveau_dmem_chunk_alloc(drm, &page);
 		if (ret)
 			return NULL;
@@ -417,14 +487,23 @@ void
 nouveau_dmem_fini(struct nouveau_drm *drm)
 {
 	struct nouveau_dmem_chunk *chunk, *tmp;
+	int cpu;
 
 	if (drm->dmem == NULL)
 		return;
 
 	mutex_lock(&drm->dmem->mutex);
 
-	list_for_each_entry_safe(chunk, tmp, &drm->dmem->chunks, list) {
+	list_for_each_entry(chunk, &drm->dmem->chunks, list)
 		nouveau_dmem_evict_chunk(chunk);
+
+	/* Return all cached pages to their chunks. */
+	for_each_possible_cpu(cpu) {
+		nouveau_dmem_pcp_drain(drm->dmem, per_cpu_ptr(drm->dmem->pcp, cpu),
+				       DMEM_PCP_NPAGES);
+	}
+
+	list_for_each_entry_safe(chunk, tmp, &drm->dmem->chunks, list) {
 		nouveau_bo_unpin(chunk->bo);
 		nouveau_bo_fini(chunk->bo);
 		WARN_ON(chunk->callocated);
@@ -436,6 +515,8 @@ nouveau_dmem_fini(struct nouveau_drm *drm)
 	}
 
 	mutex_unlock(&drm->dmem->mutex);
+	free_percpu(drm->dmem->pcp);
+	drm->dmem->pcp = NULL;
 }
 
 static int
@@ -589,7 +670,7 @@ nouveau_dmem_migrate_init(struct nouveau_drm *drm)
 void
 nouveau_dmem_init(struct nouveau_drm *drm)
 {
-	int ret;
+	int cpu, ret;
 
 	/* This only make sense on PASCAL or newer */
 	if (drm->client.device.info.family < NV_DEVICE_INFO_V0_PASCAL)
@@ -604,15 +685,26 @@ nouveau_dmem_init(struct nouveau_drm *drm)
 	mutex_init(&drm->dmem->mutex);
 	spin_lock_init(&drm->dmem->lock);
 
+	drm->dmem->pcp = alloc_percpu(struct nouveau_dmem_pcp);
+	if (!drm->dmem->pcp) {
+		kfree(drm->dmem);
+		drm->dmem = NULL;
+		return;
+	}
+
+	for_each_possible_cpu(cpu)
+		local_lock_init(&per_cpu_ptr(drm->dmem->pcp, cpu)->lock);
+
 	/* Initialize migration dma helpers before registering memory */
 	ret = nouveau_dmem_migrate_init(drm);
 	if (ret) {
+		free_percpu(drm->dmem->pcp);
 		kfree(drm->dmem);
 		drm->dmem = NULL;
 	}
 }
 
-static unsigned long nouveau_dmem_migrate_copy_one(struct nouveau_drm *drm,
+static unsigned long nouveau_dmem_migrate_alloc_one(struct nouveau_drm *drm,
 		struct nouveau_svmm *svmm, unsigned long src,
 		dma_addr_t *dma_addr, u64 *pfn)
 {
@@ -620,6 +712,8 @@ static unsigned long nouveau_dmem_migrate_copy_one(struct nouveau_drm *drm,
 	struct page *dpage, *spage;
 	unsigned long paddr;
 
+	*dma_addr = DMA_MAPPING_ERROR;
+
 	spage = migrate_pfn_to_page(src);
 	if (!(src & MIGRATE_PFN_MIGRATE))
 		goto out;
@@ -628,22 +722,16 @@ static unsigned long nouveau_dmem_migrate_copy_one(struct nouveau_drm *drm,
 	if (!dpage)
 		goto out;
 
-	paddr = nouveau_dmem_page_addr(dpage);
 	if (spage) {
 		*dma_addr = dma_map_page(dev, spage, 0, page_size(spage),
 					 DMA_BIDIRECTIONAL);
-		if (dma_mapping_error(dev, *dma_addr))
-			goto out_free_page;
-		if (drm->dmem->migrate.copy_func(drm, 1,
-			NOUVEAU_APER_VRAM, paddr, NOUVEAU_APER_HOST, *dma_addr))
-			goto out_dma_unmap;
-	} else {
-		*dma_addr = DMA_MAPPING_ERROR;
-		if (drm->dmem->migrate.clear_func(drm, page_size(dpage),
-			NOUVEAU_APER_VRAM, paddr))
+		if (dma_mapping_error(dev, *dma_addr)) {
+			*dma_addr = DMA_MAPPING_ERROR;
 			goto out_free_page;
+		}
 	}
 
+	paddr = nouveau_dmem_page_addr(dpage);
 	dpage->zone_device_data = svmm;
 	*pfn = NVIF_VMM_PFNMAP_V0_V | NVIF_VMM_PFNMAP_V0_VRAM |
 		((paddr >> PAGE_SHIFT) << NVIF_VMM_PFNMAP_V0_ADDR_SHIFT);
@@ -651,8 +739,6 @@ static unsigned long nouveau_dmem_migrate_copy_one(struct nouveau_drm *drm,
 		*pfn |= NVIF_VMM_PFNMAP_V0_W;
 	return migrate_pfn(page_to_pfn(dpage));
 
-out_dma_unmap:
-	dma_unmap_page(dev, *dma_addr, PAGE_SIZE, DMA_BIDIRECTIONAL);
 out_free_page:
 	nouveau_dmem_page_free_locked(drm, dpage);
 out:
@@ -660,28 +746,97 @@ out:
 	return 0;
 }
 
+static void nouveau_dmem_migrate_abort_one(struct nouveau_drm *drm,
+		struct migrate_vma *args, unsigned long i,
+		dma_addr_t *dma_addrs, u64 *pfns)
+{
+	struct device *dev = drm->dev->dev;
+
+	if (!dma_mapping_error(dev, dma_addrs[i])) {
+		dma_unmap_page(dev, dma_addrs[i], PAGE_SIZE,
+			       DMA_BIDIRECTIONAL);
+		dma_addrs[i] = DMA_MAPPING_ERROR;
+	}
+
+	nouveau_dmem_page_free_locked(drm, migrate_pfn_to_page(args->dst[i]));
+	args->dst[i] = 0;
+	pfns[i] = NVIF_VMM_PFNMAP_V0_NONE;
+}
+
+/*
+ * Copy (or clear) the destination pages, issuing a single multi-line copy
+ * for each run of pages that are physically contiguous on both sides.
+ */
+static void nouveau_dmem_migrate_copy(struct nouveau_drm *drm,
+		struct migrate_vma *args, unsigned long npages,
+		dma_addr_t *dma_addrs, u64 *pfns)
+{
+	struct nouveau_dmem_migrate *migrate = &drm->dmem->migrate;
+	struct device *dev = drm->dev->dev;
+	unsigned long i, j;
+
+	for (i = 0; i < npages; i = j) {
+		bool copy = !dma_mapping_error(dev, dma_addrs[i]);
+		unsigned long paddr, size;
+		int ret;
+
+		j = i + 1;
+		if (!args->dst[i])
+			continue;
+
+		paddr = nouveau_dmem_page_addr(migrate_pfn_to_page(args->dst[i]));
+		for (size = PAGE_SIZE; j < npages; j++, size += PAGE_SIZE) {
+			if (!args->dst[j] ||
+			    copy != !dma_mapping_error(dev, dma_addrs[j]) ||
+			    (copy && dma_addrs[j] != dma_addrs[i] + size))
+				break;
+
+			if (nouveau_dmem_page_addr(migrate_pfn_to_page(args->dst[j])) !=
+			    paddr + size)
+				break;
+		}
+
+		if (copy) {
+			ret = migrate->copy_func(drm, j - i,
+						 NOUVEAU_APER_VRAM, paddr,
+						 NOUVEAU_APER_HOST, dma_addrs[i]);
+		} else {
+			ret = migrate->clear_func(drm, size,
+						  NOUVEAU_APER_VRAM, paddr);
+		}
+
+		if (ret) {
+			while (i < j)
+				nouveau_dmem_migrate_abort_one(drm, args, i++,
+							       dma_addrs, pfns);
+		}
+	}
+}
+
 static void nouveau_dmem_migrate_chunk(struct nouveau_drm *drm,
 		struct nouveau_svmm *svmm, struct migrate_vma *args,
 		dma_addr_t *dma_addrs, u64 *pfns)
 {
 	struct nouveau_fence *fence;
-	unsigned long addr = args->start, nr_dma = 0, i;
+	unsigned long addr = args->start, i;
 
 	for (i = 0; addr < args->end; i++) {
-		args->dst[i] = nouveau_dmem_migrate_copy_one(drm, svmm,
-				args->src[i], dma_addrs + nr_dma, pfns + i);
-		if (!dma_mapping_error(drm->dev->dev, dma_addrs[nr_dma]))
-			nr_dma++;
+		args->dst[i] = nouveau_dmem_migrate_alloc_one(drm, svmm,
+				args->src[i], dma_addrs + i, pfns + i);
 		addr += PAGE_SIZE;
 	}
 
+	nouveau_dmem_migrate_copy(drm, args, i, dma_addrs, pfns);
+
 	nouveau_fence_new(&fence, drm->dmem->migrate.chan);
 	migrate_vma_pages(args);
 	nouveau_dmem_fence_done(&fence);
 	nouveau_pfns_map(svmm, args->vma->vm_mm, args->start, pfns, i);
 
-	while (nr_dma--) {
-		dma_unmap_page(drm->dev->dev, dma_addrs[nr_dma], PAGE_SIZE,
+	while (i--) {
+		if (dma_mapping_error(drm->dev->dev, dma_addrs[i]))
+			continue;
+		dma_unmap_page(drm->dev->dev, dma_addrs[i], PAGE_SIZE,
 				DMA_BIDIRECTIONAL);
 	}
 	migrate_vma_finalize(args);
@@ -695,7 +850,7 @@ nouveau_dmem_migrate_vma(struct nouveau_drm *drm,
 			 unsigned long end)
 {
 	unsigned long npages = (end - start) >> PAGE_SHIFT;
-	unsigned long max = min(SG_MAX_SINGLE_ALLOC, npages);
+	unsigned long max = min(DMEM_CHUNK_NPAGES, npages);
 	dma_addr_t *dma_addrs;
 	struct migrate_vma args = {
 		.vma		= vma,
@@ -703,7 +858,6 @@ nouveau_dmem_migrate_vma(struct nouveau_drm *drm,
 		.pgmap_owner	= drm->dev,
 		.flags		= MIGRATE_VMA_SELECT_SYSTEM,
 	};
-	unsigned long i;
 	u64 *pfns;
 	int ret = -ENOMEM;
 
@@ -725,11 +879,13 @@ nouveau_dmem_migrate_vma(struct nouveau_drm *drm,
 	if (!pfns)
 		goto out_free_dma;
 
-	for (i = 0; i < npages; i += max) {
-		if (args.start + (max << PAGE_SHIFT) > end)
-			args.end = end;
-		else
-			args.end = args.start + (max << PAGE_SHIFT);
+	/*
+	 * Migrate in batches that don't cross a chunk-sized (2MiB) boundary,
+	 * so that THP-backed ranges, which are physically contiguous in
+	 * system memory, can be moved with a single copy.
+	 */
+	while (args.start < end) {
+		args.end = min(ALIGN(args.start + 1, DMEM_CHUNK_SIZE), end);
 
 		ret = migrate_vma_setup(&args);
 		if (ret)
@@ -43,6 +43,8 @@
 #include <core/pci.h>
 #include <core/tegra.h>
 
+#include <subdev/bios.h>
+
 #include <nvif/driver.h>
 #include <nvif/fifo.h>
 #include <nvif/push006c.h>
@@ -1465,6 +1467,7 @@ nouveau_drm_exit(void)
 #ifdef CONFIG_NOUVEAU_PLATFORM_DRIVER
 	platform_driver_unregister(&nouveau_platform_driver);
 #endif
+	nvkm_bios_cache_fini();
 	if (IS_ENABLED(CONFIG_DRM_NOUVEAU_SVM))
 		mmu_notifier_synchronize();
 }
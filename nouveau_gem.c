@@ -618,9 +618,15 @@ static int nouveau_gem_pushbuf_reloc_apply(struct nouveau_cli *cli,
                                             struct drm_nouveau_gem_pushbuf *req,
                                             struct drm_nouveau_gem_pushbuf_reloc *reloc,
                                             struct drm_nouveau_gem_pushbuf_bo *bo) {
+    DECLARE_BITMAP(ready, NOUVEAU_GEM_MAX_BUFFERS);
     int ret = 0;
     unsigned i;
 
+    /* Container buffers are mapped and waited on once, the first time
+     * a relocation targets them, rather than for every relocation.
+     */
+    bitmap_zero(ready, req->nr_buffers);
+
     for (i = 0; i < req->nr_relocs; i++) {
         struct drm_nouveau_gem_pushbuf_reloc *r = &reloc[i];
         struct drm_nouveau_gem_pushbuf_bo *b;
@@ -651,13 +657,30 @@ static int nouveau_gem_pushbuf_reloc_apply(struct nouveau_cli *cli,
             break;
         }
 
-        if (!nvbo->kmap.virtual) {
-            ret = ttm_bo_kmap(&nvbo->bo, 0, PFN_UP(nvbo->bo.base.size), &nvbo->kmap);
+        if (!test_bit(r->reloc_bo_index, ready)) {
+            if (!nvbo->kmap.virtual) {
+                ret = ttm_bo_kmap(&nvbo->bo, 0, PFN_UP(nvbo->bo.base.size), &nvbo->kmap);
+                if (ret) {
+                    NV_PRINTK(err, cli, "failed kmap for reloc\n");
+                    break;
+                }
+                nvbo->validate_mapped = true;
+            }
+
+            lret = dma_resv_wait_timeout(nvbo->bo.base.resv, DMA_RESV_USAGE_BOOKKEEP, false, 15 * HZ);
+            if (!lret)
+                ret = -EBUSY;
+            else if (lret > 0)
+                ret = 0;
+            else
+                ret = lret;
+
             if (ret) {
-                NV_PRINTK(err, cli, "failed kmap for reloc\n");
+                NV_PRINTK(err, cli, "reloc wait_idle failed: %d\n", ret);
                 break;
             }
-            nvbo->validate_mapped = true;
+
+            __set_bit(r->reloc_bo_index, ready);
         }
 
         if (r->flags & NOUVEAU_GEM_RELOC_LOW)
@@ -673,18 +696,6 @@ static int nouveau_gem_pushbuf_reloc_apply(struct nouveau_cli *cli,
             else
                 data |= r->vor;
         }
-        lret = dma_resv_wait_timeout(nvbo->bo.base.resv, DMA_RESV_USAGE_BOOKKEEP, false, 15 * HZ);
-        if (!lret)
-            ret = -EBUSY;
-        else if (lret > 0)
-            ret = 0;
-        else
-            ret = lret;
-
-        if (ret) {
-            NV_PRINTK(err, cli, "reloc wait_idle failed: %d\n", ret);
-            break;
-        }
 
         nouveau_bo_wr32(nvbo, r->reloc_bo_offset >> 2, data);
     }
@@ -695,7 +706,7 @@ static int nouveau_gem_pushbuf_reloc_apply(struct nouveau_cli *cli,
 int nouveau_gem_ioctl_pushbuf(struct drm_device *dev, void *data, struct drm_file *file_priv) {
     struct nouveau_abi16 *abi16 = nouveau_abi16_get(file_priv);
     struct nouveau_cli *cli = nouveau_cli(file_priv);
-    struct nouveau_abi16_chan *temp;
+    struct nouveau_abi16_chan *temp, *achan = NULL;
     struct nouveau_drm *drm = nouveau_drm(dev);
     struct drm_nouveau_gem_pushbuf *req = data;
     struct drm_nouveau_gem_pushbuf_push *push;
@@ -715,6 +726,7 @@ int nouveau_gem_ioctl_pushbuf(struct drm_device *dev, void *data, struct drm_fil
 
     list_for_each_entry(temp, &abi16->channels, head) {
         if (temp->chan->chid == req->channel) {
+            achan = temp;
             chan = temp->chan;
             break;
         }
@@ -767,6 +779,19 @@ int nouveau_gem_ioctl_pushbuf(struct drm_device *dev, void *data, struct drm_fil
             goto out_prevalid;
         }
     }
+
+    /* If the previous submission on this channel needed relocations,
+     * this one likely will too.  Copy them in before validation, rather
+     * than validating, backing off to copy them and validating again.
+     */
+    if (achan->relocs && req->nr_relocs) {
+        reloc = u_memcpya(req->relocs, req->nr_relocs, sizeof(*reloc));
+        if (IS_ERR(reloc)) {
+            ret = PTR_ERR(reloc);
+            goto out_prevalid;
+        }
+    }
+
     revalidate:
     ret = nouveau_gem_pushbuf_validate(chan, file_priv, bo,
                                        req->nr_buffers, &op, &do_reloc);
@@ -776,7 +801,12 @@ int nouveau_gem_ioctl_pushbuf(struct drm_device *dev, void *data, struct drm_fil
         goto out_prevalid;
     }
 
-    if (do_reloc) {
+    achan->relocs = do_reloc;
+
+    /* Presumed offsets are stale, but there's nothing to patch.  They
+     * still get written back to userspace below.
+     */
+    if (do_reloc && req->nr_relocs) {
         if (!reloc) {
             validate_fini(&op, chan, NULL, bo);
             reloc = u_memcpya(req->relocs, req->nr_relocs, sizeof(*reloc));
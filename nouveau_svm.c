@@ -34,14 +34,43 @@
 
 #include <linux/sched/mm.h>
 #include <linux/sort.h>
+#include <linux/log2.h>
+#include <linux/hashtable.h>
 #include <linux/hmm.h>
 #include <linux/memremap.h>
 #include <linux/rmap.h>
 
+MODULE_PARM_DESC(svm_window, "Maximum SVM fault window in KiB, 4-2048 (default: 2048)");
+static int nouveau_svm_window = 2048;
+module_param_named(svm_window, nouveau_svm_window, int, 0400);
+
+MODULE_PARM_DESC(svm_migrate, "Migrate a 2MiB region to VRAM once it takes this "
+			      "many GPU faults within a second (default: 0, disabled)");
+static int nouveau_svm_migrate;
+module_param_named(svm_migrate, nouveau_svm_migrate, int, 0600);
+
 struct nouveau_svm {
 	struct nouveau_drm *drm;
 	struct mutex mutex;
-	struct list_head inst;
+	DECLARE_HASHTABLE(inst, 6);
+
+	struct {
+		u32 min;
+		u32 max;
+	} window;
+
+	/* Regions queued for migration to VRAM by the fault handler. */
+	struct {
+		spinlock_t lock;
+		struct work_struct work;
+		wait_queue_head_t wait;
+		struct nouveau_svmm *busy;
+		struct {
+			struct nouveau_svmm *svmm;
+			u64 addr;
+		} region[8];
+		int nr;
+	} migrate;
 
 	struct nouveau_svm_fault_buffer {
 		int id;
@@ -65,8 +94,14 @@ struct nouveau_svm {
 			u8  client;
 			u8  fault;
 			struct nouveau_svmm *svmm;
-		} **fault;
+		} *faults, **fault;
 		int fault_nr;
+		u32 *entry;
+		u32 dedup[64];
+
+		struct nouveau_pfnmap_args *args;
+		unsigned long *hmm_pfns;
+		unsigned long *hmm_req;
 	} buffer[];
 };
 
@@ -84,17 +119,29 @@ struct nouveau_pfnmap_args {
 	struct nvif_vmm_pfnmap_v0 p;
 };
 
+/* Smallest fault window, matches the GPU's large page size. */
+#define NOUVEAU_SVM_WINDOW_MIN SZ_64K
+
+/* Granularity at which GPU access is tracked for migration to VRAM. */
+#define NOUVEAU_SVM_HOT_SIZE SZ_2M
+
 struct nouveau_ivmm {
 	struct nouveau_svmm *svmm;
 	u64 inst;
-	struct list_head head;
+	struct hlist_node head;
+	struct rcu_head rcu;
 };
 
+/* Lookup the SVMM a channel instance is linked to.
+ *
+ * Must be called with either svm->mutex held, or under rcu_read_lock().
+ */
 static struct nouveau_ivmm *
 nouveau_ivmm_find(struct nouveau_svm *svm, u64 inst)
 {
 	struct nouveau_ivmm *ivmm;
-	list_for_each_entry(ivmm, &svm->inst, head) {
+	hash_for_each_possible_rcu(svm->inst, ivmm, head, inst,
+				   lockdep_is_held(&svm->mutex)) {
 		if (ivmm->inst == inst)
 			return ivmm;
 	}
@@ -106,6 +153,31 @@ nouveau_ivmm_find(struct nouveau_svm *svm, u64 inst)
 #define SVMM_ERR(s,f,a...)                                                     \
 	NV_WARN((s)->vmm->cli->drm, "svm-%p: "f"\n", (s), ##a)
 
+/* Migrate all pages within an address range to VRAM.
+ *
+ * Must be called with mmap_lock held for read.
+ */
+static void
+nouveau_svmm_migrate(struct nouveau_drm *drm, struct nouveau_svmm *svmm,
+		     struct mm_struct *mm, unsigned long addr,
+		     unsigned long end)
+{
+	while (addr < end) {
+		struct vm_area_struct *vma;
+		unsigned long next;
+
+		vma = find_vma_intersection(mm, addr, end);
+		if (!vma)
+			break;
+
+		addr = max(addr, vma->vm_start);
+		next = min(vma->vm_end, end);
+		/* This is a best effort so we ignore errors */
+		nouveau_dmem_migrate_vma(drm, svmm, vma, addr, next);
+		addr = next;
+	}
+}
+
 int
 nouveau_svmm_bind(struct drm_device *dev, void *data,
 		  struct drm_file *file_priv)
@@ -113,7 +185,6 @@ nouveau_svmm_bind(struct drm_device *dev, void *data,
 	struct nouveau_cli *cli = nouveau_cli(file_priv);
 	struct drm_nouveau_svm_bind *args = data;
 	unsigned target, cmd;
-	unsigned long addr, end;
 	struct mm_struct *mm;
 
 	args->va_start &= PAGE_MASK;
@@ -172,21 +243,8 @@ nouveau_svmm_bind(struct drm_device *dev, void *data,
 		return -EINVAL;
 	}
 
-	for (addr = args->va_start, end = args->va_end; addr < end;) {
-		struct vm_area_struct *vma;
-		unsigned long next;
-
-		vma = find_vma_intersection(mm, addr, end);
-		if (!vma)
-			break;
-
-		addr = max(addr, vma->vm_start);
-		next = min(vma->vm_end, end);
-		/* This is a best effort so we ignore errors */
-		nouveau_dmem_migrate_vma(cli->drm, cli->svm.svmm, vma, addr,
-					 next);
-		addr = next;
-	}
+	nouveau_svmm_migrate(cli->drm, cli->svm.svmm, mm,
+			     args->va_start, args->va_end);
 
 	/*
 	 * FIXME Return the number of page we have migrated, again we need to
@@ -210,8 +268,8 @@ nouveau_svmm_part(struct nouveau_svmm *svmm, u64 inst)
 		mutex_lock(&svmm->vmm->cli->drm->svm->mutex);
 		ivmm = nouveau_ivmm_find(svmm->vmm->cli->drm->svm, inst);
 		if (ivmm) {
-			list_del(&ivmm->head);
-			kfree(ivmm);
+			hash_del_rcu(&ivmm->head);
+			kfree_rcu(ivmm, rcu);
 		}
 		mutex_unlock(&svmm->vmm->cli->drm->svm->mutex);
 	}
@@ -229,7 +287,7 @@ nouveau_svmm_join(struct nouveau_svmm *svmm, u64 inst)
 		ivmm->inst = inst;
 
 		mutex_lock(&svmm->vmm->cli->drm->svm->mutex);
-		list_add(&ivmm->head, &svmm->vmm->cli->drm->svm->inst);
+		hash_add_rcu(svmm->vmm->cli->drm->svm->inst, &ivmm->head, inst);
 		mutex_unlock(&svmm->vmm->cli->drm->svm->mutex);
 	}
 	return 0;
@@ -304,6 +362,8 @@ nouveau_svmm_fini(struct nouveau_svmm **psvmm)
 {
 	struct nouveau_svmm *svmm = *psvmm;
 	if (svmm) {
+		nouveau_svm_migrate_cancel(svmm->vmm->cli->drm->svm, svmm);
+
 		mutex_lock(&svmm->mutex);
 		svmm->vmm = NULL;
 		mutex_unlock(&svmm->mutex);
@@ -451,46 +511,48 @@ nouveau_svm_fault_cmp(const void *a, const void *b)
 
 static void
 nouveau_svm_fault_cache(struct nouveau_svm *svm,
-			struct nouveau_svm_fault_buffer *buffer, u32 offset)
+			struct nouveau_svm_fault_buffer *buffer,
+			const u32 *entry, u32 offset)
 {
 	struct nvif_object *memory = &buffer->object;
-	const u32 instlo = nvif_rd32(memory, offset + 0x00);
-	const u32 insthi = nvif_rd32(memory, offset + 0x04);
-	const u32 addrlo = nvif_rd32(memory, offset + 0x08);
-	const u32 addrhi = nvif_rd32(memory, offset + 0x0c);
-	const u32 timelo = nvif_rd32(memory, offset + 0x10);
-	const u32 timehi = nvif_rd32(memory, offset + 0x14);
-	const u32 engine = nvif_rd32(memory, offset + 0x18);
-	const u32   info = nvif_rd32(memory, offset + 0x1c);
-	const u64   inst = (u64)insthi << 32 | instlo;
+	const u32   info = entry[7];
+	const u64   inst = (u64)entry[1] << 32 | entry[0];
+	const u64   addr = (u64)entry[3] << 32 | entry[2];
 	const u8     gpc = (info & 0x1f000000) >> 24;
 	const u8     hub = (info & 0x00100000) >> 20;
+	const u8  access = (info & 0x000f0000) >> 16;
 	const u8  client = (info & 0x00007f00) >> 8;
 	struct nouveau_svm_fault *fault;
+	u32 *dedup;
 
 	//XXX: i think we're supposed to spin waiting */
 	if (WARN_ON(!(info & 0x80000000)))
 		return;
 
-	nvif_mask(memory, offset + 0x1c, 0x80000000, 0x00000000);
+	nvif_wr32(memory, offset + 0x1c, info & ~0x80000000);
 
-	if (!buffer->fault[buffer->fault_nr]) {
-		fault = kmalloc(sizeof(*fault), GFP_KERNEL);
-		if (WARN_ON(!fault)) {
-			nouveau_svm_fault_cancel(svm, inst, hub, gpc, client);
+	/* Drop exact duplicates of a fault already pending in this batch,
+	 * they'll be retried along with the original by the replay.
+	 */
+	dedup = &buffer->dedup[hash_64(inst ^ addr ^ access, 6)];
+	if (*dedup < buffer->fault_nr) {
+		fault = &buffer->faults[*dedup];
+		if (fault->inst == inst && fault->addr == addr &&
+		    fault->access == access && fault->gpc == gpc &&
+		    fault->hub == hub && fault->client == client)
 			return;
-		}
-		buffer->fault[buffer->fault_nr] = fault;
 	}
 
-	fault = buffer->fault[buffer->fault_nr++];
+	*dedup = buffer->fault_nr;
+	fault = &buffer->faults[buffer->fault_nr];
+	buffer->fault[buffer->fault_nr++] = fault;
 	fault->inst   = inst;
-	fault->addr   = (u64)addrhi << 32 | addrlo;
-	fault->time   = (u64)timehi << 32 | timelo;
-	fault->engine = engine;
+	fault->addr   = addr;
+	fault->time   = (u64)entry[5] << 32 | entry[4];
+	fault->engine = entry[6];
 	fault->gpc    = gpc;
 	fault->hub    = hub;
-	fault->access = (info & 0x000f0000) >> 16;
+	fault->access = access;
 	fault->client = client;
 	fault->fault  = (info & 0x0000001f);
 
@@ -534,10 +596,30 @@ static const struct mmu_interval_notifier_ops nouveau_svm_mni_ops = {
 	.invalidate = nouveau_svm_range_invalidate,
 };
 
+static u64
+nouveau_hmm_convert_phys(unsigned long hmm_pfn, struct page *page)
+{
+	u64 phys;
+
+	if (is_device_private_page(page))
+		phys = nouveau_dmem_page_addr(page) |
+		       NVIF_VMM_PFNMAP_V0_V |
+		       NVIF_VMM_PFNMAP_V0_VRAM;
+	else
+		phys = page_to_phys(page) |
+		       NVIF_VMM_PFNMAP_V0_V |
+		       NVIF_VMM_PFNMAP_V0_HOST;
+	if (hmm_pfn & HMM_PFN_WRITE)
+		phys |= NVIF_VMM_PFNMAP_V0_W;
+	return phys;
+}
+
 static void nouveau_hmm_convert_pfn(struct nouveau_drm *drm,
 				    struct hmm_range *range,
 				    struct nouveau_pfnmap_args *args)
 {
+	unsigned long npages = (range->end - range->start) >> PAGE_SHIFT;
+	unsigned long i;
 	struct page *page;
 
 	/*
@@ -547,39 +629,45 @@ static void nouveau_hmm_convert_pfn(struct nouveau_drm *drm,
 	 * This is all just encoding the internal hmm representation into a
 	 * different nouveau internal representation.
 	 */
-	if (!(range->hmm_pfns[0] & HMM_PFN_VALID)) {
-		args->p.phys[0] = 0;
-		return;
+	if (range->hmm_pfns[0] & HMM_PFN_VALID) {
+		unsigned int order = hmm_pfn_to_map_order(range->hmm_pfns[0]);
+		u64 size = 1ULL << (order + PAGE_SHIFT);
+
+		/*
+		 * Only map compound pages to the GPU if the CPU is also
+		 * mapping the page as a compound page, and that mapping
+		 * covers the entire fault window. Otherwise, the PTE
+		 * protections might not be consistent (e.g., CPU only maps
+		 * part of a compound page).
+		 * Note that the underlying page might still be larger than
+		 * the CPU mapping (e.g., a PUD sized compound page partially
+		 * mapped with a PMD sized page table entry).
+		 */
+		if (order && ALIGN_DOWN(range->start, size) + size >= range->end) {
+			unsigned long addr = args->p.addr;
+
+			page = hmm_pfn_to_page(range->hmm_pfns[0]);
+			args->p.page = order + PAGE_SHIFT;
+			args->p.size = size;
+			args->p.addr &= ~(args->p.size - 1);
+			page -= (addr - args->p.addr) >> PAGE_SHIFT;
+			args->p.phys[0] =
+				nouveau_hmm_convert_phys(range->hmm_pfns[0],
+							 page);
+			return;
+		}
 	}
 
-	page = hmm_pfn_to_page(range->hmm_pfns[0]);
-	/*
-	 * Only map compound pages to the GPU if the CPU is also mapping the
-	 * page as a compound page. Otherwise, the PTE protections might not be
-	 * consistent (e.g., CPU only maps part of a compound page).
-	 * Note that the underlying page might still be larger than the
-	 * CPU mapping (e.g., a PUD sized compound page partially mapped with
-	 * a PMD sized page table entry).
-	 */
-	if (hmm_pfn_to_map_order(range->hmm_pfns[0])) {
-		unsigned long addr = args->p.addr;
-
-		args->p.page = hmm_pfn_to_map_order(range->hmm_pfns[0]) +
-				PAGE_SHIFT;
-		args->p.size = 1UL << args->p.page;
-		args->p.addr &= ~(args->p.size - 1);
-		page -= (addr - args->p.addr) >> PAGE_SHIFT;
+	for (i = 0; i < npages; i++) {
+		if (!(range->hmm_pfns[i] & HMM_PFN_VALID)) {
+			args->p.phys[i] = 0;
+			continue;
+		}
+
+		page = hmm_pfn_to_page(range->hmm_pfns[i]);
+		args->p.phys[i] = nouveau_hmm_convert_phys(range->hmm_pfns[i],
+							   page);
 	}
-	if (is_device_private_page(page))
-		args->p.phys[0] = nouveau_dmem_page_addr(page) |
-				NVIF_VMM_PFNMAP_V0_V |
-				NVIF_VMM_PFNMAP_V0_VRAM;
-	else
-		args->p.phys[0] = page_to_phys(page) |
-				NVIF_VMM_PFNMAP_V0_V |
-				NVIF_VMM_PFNMAP_V0_HOST;
-	if (range->hmm_pfns[0] & HMM_PFN_WRITE)
-		args->p.phys[0] |= NVIF_VMM_PFNMAP_V0_W;
 }
 
 static int nouveau_atomic_range_fault(struct nouveau_svmm *svmm,
@@ -647,17 +735,21 @@ out:
 
 static int nouveau_range_fault(struct nouveau_svmm *svmm,
 			       struct nouveau_drm *drm,
-			       struct nouveau_pfnmap_args *args, u32 size,
-			       unsigned long hmm_flags,
+			       struct nouveau_pfnmap_args *args,
+			       unsigned long *hmm_pfns,
+			       const unsigned long *hmm_req,
 			       struct svm_notifier *notifier)
 {
 	unsigned long timeout =
 		jiffies + msecs_to_jiffies(HMM_RANGE_DEFAULT_TIMEOUT);
-	/* Have HMM fault pages within the fault window to the GPU. */
-	unsigned long hmm_pfns[1];
+	unsigned long npages = args->p.size >> PAGE_SHIFT;
+	/* Have HMM fault pages within the fault window to the GPU, pages
+	 * without a request in hmm_req are only reported if already present.
+	 */
 	struct hmm_range range = {
 		.notifier = &notifier->notifier,
-		.default_flags = hmm_flags,
+		.default_flags = 0,
+		.pfn_flags_mask = HMM_PFN_REQ_FAULT | HMM_PFN_REQ_WRITE,
 		.hmm_pfns = hmm_pfns,
 		.dev_private_owner = drm->dev,
 	};
@@ -679,6 +771,9 @@ static int nouveau_range_fault(struct nouveau_svmm *svmm,
 			goto out;
 		}
 
+		/* hmm_range_fault() overwrites the request flags. */
+		memcpy(hmm_pfns, hmm_req, npages * sizeof(*hmm_pfns));
+
 		range.notifier_seq = mmu_interval_read_begin(range.notifier);
 		mmap_read_lock(mm);
 		ret = hmm_range_fault(&range);
@@ -700,7 +795,10 @@ static int nouveau_range_fault(struct nouveau_svmm *svmm,
 
 	nouveau_hmm_convert_pfn(drm, &range, args);
 
-	ret = nvif_object_ioctl(&svmm->vmm->vmm.object, args, size, NULL);
+	ret = nvif_object_ioctl(&svmm->vmm->vmm.object, args,
+				struct_size(args, p.phys,
+					    args->p.size >> args->p.page),
+				NULL);
 	mutex_unlock(&svmm->mutex);
 
 out:
@@ -709,21 +807,205 @@ out:
 	return ret;
 }
 
+/* Determine the window of addresses to handle along with a fault at addr.
+ *
+ * Faults that land just beyond the previous window are treated as part
+ * of a sequential stream, and grow the window (up to the configured
+ * maximum) so that more of the stream is made available to the GPU in
+ * a single update.  Any other fault drops back to the smallest window.
+ */
+static void
+nouveau_svm_fault_window(struct nouveau_svm *svm, struct nouveau_svmm *svmm,
+			 u64 addr, u64 *pstart, u64 *plimit)
+{
+	u32 window = svmm->fault.window;
+	u64 start, limit;
+
+	if (window && addr >= svmm->fault.next &&
+	    addr - svmm->fault.next < window)
+		window = min(window << 1, svm->window.max);
+	else
+		window = svm->window.min;
+
+	start = ALIGN_DOWN(addr, window);
+	limit = start + window;
+
+	/* Keep the window out of the unmanaged region. */
+	if (limit > svmm->unmanaged.start && start < svmm->unmanaged.limit) {
+		if (addr + PAGE_SIZE <= svmm->unmanaged.start) {
+			limit = ALIGN_DOWN(svmm->unmanaged.start, PAGE_SIZE);
+		} else
+		if (addr >= svmm->unmanaged.limit) {
+			start = ALIGN(svmm->unmanaged.limit, PAGE_SIZE);
+		} else {
+			start = addr;
+			limit = addr + PAGE_SIZE;
+		}
+	}
+
+	svmm->fault.window = window;
+	svmm->fault.next = limit;
+	*pstart = start;
+	*plimit = limit;
+}
+
+/* HMM request flags needed to satisfy a GPU fault access type. */
+static unsigned long
+nouveau_svm_fault_hmm_flags(u8 access)
+{
+	switch (access) {
+	case FAULT_ACCESS_PREFETCH:
+		return 0;
+	case FAULT_ACCESS_READ:
+		return HMM_PFN_REQ_FAULT;
+	default:
+		return HMM_PFN_REQ_FAULT | HMM_PFN_REQ_WRITE;
+	}
+}
+
+/* Check whether a GPU mapping has sufficient access permission to
+ * satisfy a pending fault.
+ */
+static bool
+nouveau_svm_fault_done(struct nouveau_svm_fault *fault, u64 phys)
+{
+	switch (fault->access) {
+	case FAULT_ACCESS_PREFETCH:
+		return true;
+	case FAULT_ACCESS_READ:
+		return phys & NVIF_VMM_PFNMAP_V0_V;
+	case FAULT_ACCESS_WRITE:
+		return phys & NVIF_VMM_PFNMAP_V0_W;
+	default:
+		return phys & NVIF_VMM_PFNMAP_V0_A;
+	}
+}
+
+/* Account a handled GPU fault against the region containing it, and
+ * queue the region for migration to VRAM once it has taken enough
+ * faults in a short enough period of time to be considered hot.
+ *
+ * Returns true if the region was queued.
+ */
+static bool
+nouveau_svm_fault_hot(struct nouveau_svm *svm,
+		      struct nouveau_svmm *svmm, u64 addr)
+{
+	const int threshold = READ_ONCE(nouveau_svm_migrate);
+	u64 region = ALIGN_DOWN(addr, NOUVEAU_SVM_HOT_SIZE);
+	struct nouveau_svmm_hot *hot;
+	bool queued = false;
+	int i;
+
+	if (threshold <= 0)
+		return false;
+
+	/* Leave anything overlapping the unmanaged region alone. */
+	if (region + NOUVEAU_SVM_HOT_SIZE > svmm->unmanaged.start &&
+	    region < svmm->unmanaged.limit)
+		return false;
+
+	hot = &svmm->hot[hash_64(region, ilog2(ARRAY_SIZE(svmm->hot)))];
+	if (hot->addr != region || time_after(jiffies, hot->stamp + HZ)) {
+		hot->addr = region;
+		hot->stamp = jiffies;
+		hot->count = 0;
+	}
+
+	if (++hot->count < threshold)
+		return false;
+	hot->count = 0;
+
+	spin_lock(&svm->migrate.lock);
+	for (i = 0; i < svm->migrate.nr; i++) {
+		if (svm->migrate.region[i].svmm == svmm &&
+		    svm->migrate.region[i].addr == region)
+			break;
+	}
+
+	if (i == svm->migrate.nr && i < ARRAY_SIZE(svm->migrate.region)) {
+		svm->migrate.region[i].svmm = svmm;
+		svm->migrate.region[i].addr = region;
+		svm->migrate.nr++;
+		queued = true;
+	}
+	spin_unlock(&svm->migrate.lock);
+	return queued;
+}
+
+/* Migrate regions that were found to be hot during fault handling.
+ *
+ * This runs separately from the fault handler so that allocating VRAM and
+ * copying doesn't hold up other faults.  The system memory mappings made
+ * for the faults are torn down by the migration, and any GPU access that
+ * lands in the region before the VRAM mappings are made will fault again.
+ *
+ * Cold regions aren't moved back out of VRAM here, that's left to the
+ * core mm (CPU access, or eviction of the whole chunk on suspend).
+ */
+static void
+nouveau_svm_migrate_work(struct work_struct *work)
+{
+	struct nouveau_svm *svm = container_of(work, typeof(*svm), migrate.work);
+
+	spin_lock(&svm->migrate.lock);
+	while (svm->migrate.nr) {
+		struct nouveau_svmm *svmm = svm->migrate.region[0].svmm;
+		struct mm_struct *mm = svmm->notifier.mm;
+		u64 addr = svm->migrate.region[0].addr;
+
+		svm->migrate.nr--;
+		memmove(&svm->migrate.region[0], &svm->migrate.region[1],
+			svm->migrate.nr * sizeof(svm->migrate.region[0]));
+		WRITE_ONCE(svm->migrate.busy, svmm);
+		spin_unlock(&svm->migrate.lock);
+
+		if (mmget_not_zero(mm)) {
+			SVMM_DBG(svmm, "migrate %016llx", addr);
+			mmap_read_lock(mm);
+			nouveau_svmm_migrate(svm->drm, svmm, mm, addr,
+					     addr + NOUVEAU_SVM_HOT_SIZE);
+			mmap_read_unlock(mm);
+			mmput(mm);
+		}
+
+		spin_lock(&svm->migrate.lock);
+		WRITE_ONCE(svm->migrate.busy, NULL);
+		wake_up_all(&svm->migrate.wait);
+	}
+	spin_unlock(&svm->migrate.lock);
+}
+
+/* Drop any queued migrations for an SVMM, and wait for one in progress. */
+static void
+nouveau_svm_migrate_cancel(struct nouveau_svm *svm, struct nouveau_svmm *svmm)
+{
+	int i, j;
+
+	spin_lock(&svm->migrate.lock);
+	for (i = 0, j = 0; i < svm->migrate.nr; i++) {
+		if (svm->migrate.region[i].svmm != svmm)
+			svm->migrate.region[j++] = svm->migrate.region[i];
+	}
+	svm->migrate.nr = j;
+	spin_unlock(&svm->migrate.lock);
+
+	wait_event(svm->migrate.wait, READ_ONCE(svm->migrate.busy) != svmm);
+}
+
 static void
 nouveau_svm_fault(struct work_struct *work)
 {
 	struct nouveau_svm_fault_buffer *buffer = container_of(work, typeof(*buffer), work);
 	struct nouveau_svm *svm = container_of(buffer, typeof(*svm), buffer[buffer->id]);
 	struct nvif_object *device = &svm->drm->client.device.object;
+	struct nouveau_pfnmap_args *args = buffer->args;
 	struct nouveau_svmm *svmm;
-	struct {
-		struct nouveau_pfnmap_args i;
-		u64 phys[1];
-	} args;
-	unsigned long hmm_flags;
+	unsigned long npages, i;
 	u64 inst, start, limit;
 	int fi, fn;
-	int replay = 0, atomic = 0, ret;
+	int replay = 0, ret;
+	bool migrate = false;
 
 	/* Parse available fault buffer entries into a cache, and update
 	 * the GET pointer so HW can reuse the entries.
@@ -739,8 +1021,19 @@ nouveau_svm_fault(struct work_struct *work)
 
 	SVM_DBG(svm, "get %08x put %08x", buffer->get, buffer->put);
 	while (buffer->get != buffer->put) {
-		nouveau_svm_fault_cache(svm, buffer, buffer->get * 0x20);
-		if (++buffer->get == buffer->entries)
+		u32 count = (buffer->put > buffer->get ? buffer->put :
+			     buffer->entries) - buffer->get;
+
+		/* Copy contiguous entries out of the buffer in one go. */
+		memcpy_fromio(buffer->entry, (u8 __iomem *)buffer->object.map.ptr +
+			      buffer->get * 0x20, count * 0x20);
+		for (i = 0; i < count; i++) {
+			nouveau_svm_fault_cache(svm, buffer, &buffer->entry[i * 8],
+						(buffer->get + i) * 0x20);
+		}
+
+		buffer->get += count;
+		if (buffer->get == buffer->entries)
 			buffer->get = 0;
 	}
 	nvif_wr32(device, buffer->getaddr, buffer->get);
@@ -754,7 +1047,7 @@ nouveau_svm_fault(struct work_struct *work)
 	     nouveau_svm_fault_cmp, NULL);
 
 	/* Lookup SVMM structure for each unique instance pointer. */
-	mutex_lock(&svm->mutex);
+	rcu_read_lock();
 	for (fi = 0, svmm = NULL; fi < buffer->fault_nr; fi++) {
 		if (!svmm || buffer->fault[fi]->inst != inst) {
 			struct nouveau_ivmm *ivmm =
@@ -765,118 +1058,135 @@ nouveau_svm_fault(struct work_struct *work)
 		}
 		buffer->fault[fi]->svmm = svmm;
 	}
-	mutex_unlock(&svm->mutex);
+	rcu_read_unlock();
 
 	/* Process list of faults. */
-	args.i.i.version = 0;
-	args.i.i.type = NVIF_IOCTL_V0_MTHD;
-	args.i.m.version = 0;
-	args.i.m.method = NVIF_VMM_V0_PFNMAP;
-	args.i.p.version = 0;
+	args->i.version = 0;
+	args->i.type = NVIF_IOCTL_V0_MTHD;
+	args->m.version = 0;
+	args->m.method = NVIF_VMM_V0_PFNMAP;
+	args->p.version = 0;
 
 	for (fi = 0; fn = fi + 1, fi < buffer->fault_nr; fi = fn) {
+		struct nouveau_svm_fault *fault = buffer->fault[fi];
 		struct svm_notifier notifier;
 		struct mm_struct *mm;
 
 		/* Cancel any faults from non-SVM channels. */
-		if (!(svmm = buffer->fault[fi]->svmm)) {
-			nouveau_svm_fault_cancel_fault(svm, buffer->fault[fi]);
+		if (!(svmm = fault->svmm)) {
+			nouveau_svm_fault_cancel_fault(svm, fault);
 			continue;
 		}
-		SVMM_DBG(svmm, "addr %016llx", buffer->fault[fi]->addr);
-
-		/* We try and group handling of faults within a small
-		 * window into a single update.
-		 */
-		start = buffer->fault[fi]->addr;
-		limit = start + PAGE_SIZE;
-		if (start < svmm->unmanaged.limit)
-			limit = min_t(u64, limit, svmm->unmanaged.start);
-
-		/*
-		 * Prepare the GPU-side update of all pages within the
-		 * fault window, determining required pages and access
-		 * permissions based on pending faults.
-		 */
-		args.i.p.addr = start;
-		args.i.p.page = PAGE_SHIFT;
-		args.i.p.size = PAGE_SIZE;
-		/*
-		 * Determine required permissions based on GPU fault
-		 * access flags.
-		 */
-		switch (buffer->fault[fi]->access) {
-		case 0: /* READ. */
-			hmm_flags = HMM_PFN_REQ_FAULT;
-			break;
-		case 2: /* ATOMIC. */
-			atomic = true;
-			break;
-		case 3: /* PREFETCH. */
-			hmm_flags = 0;
-			break;
-		default:
-			hmm_flags = HMM_PFN_REQ_FAULT | HMM_PFN_REQ_WRITE;
-			break;
-		}
+		SVMM_DBG(svmm, "addr %016llx", fault->addr);
 
 		mm = svmm->notifier.mm;
 		if (!mmget_not_zero(mm)) {
-			nouveau_svm_fault_cancel_fault(svm, buffer->fault[fi]);
+			nouveau_svm_fault_cancel_fault(svm, fault);
 			continue;
 		}
 
 		notifier.svmm = svmm;
-		if (atomic)
-			ret = nouveau_atomic_range_fault(svmm, svm->drm,
-							 &args.i, sizeof(args),
+		if (fault->access == FAULT_ACCESS_ATOMIC) {
+			args->p.addr = fault->addr;
+			args->p.page = PAGE_SHIFT;
+			args->p.size = PAGE_SIZE;
+			ret = nouveau_atomic_range_fault(svmm, svm->drm, args,
+							 struct_size(args, p.phys, 1),
 							 &notifier);
-		else
-			ret = nouveau_range_fault(svmm, svm->drm, &args.i,
-						  sizeof(args), hmm_flags,
-						  &notifier);
-		mmput(mm);
+			goto done;
+		}
 
-		limit = args.i.p.addr + args.i.p.size;
-		for (fn = fi; ++fn < buffer->fault_nr; ) {
-			/* It's okay to skip over duplicate addresses from the
-			 * same SVMM as faults are ordered by access type such
-			 * that only the first one needs to be handled.
-			 *
-			 * ie. WRITE faults appear first, thus any handling of
-			 * pending READ faults will already be satisfied.
-			 * But if a large page is mapped, make sure subsequent
-			 * fault addresses have sufficient access permission.
+		/* We try and group handling of faults within a window
+		 * into a single update.
+		 *
+		 * Each page with a pending fault is faulted in with the
+		 * permissions its faults require, the remainder of the
+		 * window is mapped only where the CPU already has the
+		 * page present.
+		 */
+		nouveau_svm_fault_window(svm, svmm, fault->addr, &start, &limit);
+retry:
+		npages = (limit - start) >> PAGE_SHIFT;
+		for (i = 0; i < npages; i++)
+			buffer->hmm_req[i] = 0;
+		for (fn = fi; fn < buffer->fault_nr; fn++) {
+			struct nouveau_svm_fault *next = buffer->fault[fn];
+
+			/* Faults from other instances sharing this SVMM may
+			 * sort after this one, but at a lower address.
 			 */
-			if (buffer->fault[fn]->svmm != svmm ||
-			    buffer->fault[fn]->addr >= limit ||
-			    (buffer->fault[fi]->access == FAULT_ACCESS_READ &&
-			     !(args.phys[0] & NVIF_VMM_PFNMAP_V0_V)) ||
-			    (buffer->fault[fi]->access != FAULT_ACCESS_READ &&
-			     buffer->fault[fi]->access != FAULT_ACCESS_PREFETCH &&
-			     !(args.phys[0] & NVIF_VMM_PFNMAP_V0_W)) ||
-			    (buffer->fault[fi]->access != FAULT_ACCESS_READ &&
-			     buffer->fault[fi]->access != FAULT_ACCESS_WRITE &&
-			     buffer->fault[fi]->access != FAULT_ACCESS_PREFETCH &&
-			     !(args.phys[0] & NVIF_VMM_PFNMAP_V0_A)))
+			if (next->svmm != svmm ||
+			    next->addr < start || next->addr >= limit)
+				break;
+			buffer->hmm_req[(next->addr - start) >> PAGE_SHIFT] |=
+				nouveau_svm_fault_hmm_flags(next->access);
+		}
+
+		args->p.addr = start;
+		args->p.page = PAGE_SHIFT;
+		args->p.size = limit - start;
+		ret = nouveau_range_fault(svmm, svm->drm, args,
+					  buffer->hmm_pfns, buffer->hmm_req,
+					  &notifier);
+		if (ret && npages > 1) {
+			/* Something else in the window couldn't be faulted
+			 * in, fall back to handling only this fault.
+			 */
+			start = fault->addr;
+			limit = start + PAGE_SIZE;
+			svmm->fault.window = 0;
+			goto retry;
+		}
+
+done:
+		mmput(mm);
+
+		/* It's okay to skip over any other faults from the same SVMM
+		 * covered by the update, as long as the mapping we created
+		 * has sufficient access permission to satisfy them.
+		 *
+		 * Faults on the same address are ordered by access type,
+		 * so the first one not satisfied (eg. an ATOMIC fault that
+		 * needs special handling) starts the next update.
+		 */
+		limit = args->p.addr + args->p.size;
+		for (fn = fi + 1; !ret && fn < buffer->fault_nr; fn++) {
+			struct nouveau_svm_fault *next = buffer->fault[fn];
+			u64 phys;
+
+			if (next->svmm != svmm ||
+			    next->addr < args->p.addr || next->addr >= limit)
+				break;
+
+			phys = args->p.phys[(next->addr - args->p.addr) >>
+					    args->p.page];
+			if (!nouveau_svm_fault_done(next, phys))
 				break;
 		}
 
 		/* If handling failed completely, cancel all faults. */
 		if (ret) {
-			while (fi < fn) {
-				struct nouveau_svm_fault *fault =
-					buffer->fault[fi++];
-
-				nouveau_svm_fault_cancel_fault(svm, fault);
-			}
-		} else
+			while (fi < fn)
+				nouveau_svm_fault_cancel_fault(svm,
+							       buffer->fault[fi++]);
+		} else {
+			u64 phys = args->p.phys[(fault->addr - args->p.addr) >>
+						args->p.page];
+
+			/* Only system memory pages are candidates to move. */
+			if ((phys & NVIF_VMM_PFNMAP_V0_V) &&
+			    (phys & NVIF_VMM_PFNMAP_V0_APER) == NVIF_VMM_PFNMAP_V0_HOST)
+				migrate |= nouveau_svm_fault_hot(svm, svmm, fault->addr);
 			replay++;
+		}
 	}
 
 	/* Issue fault replay to the GPU. */
 	if (replay)
 		nouveau_svm_fault_replay(svm);
+
+	if (migrate)
+		schedule_work(&svm->migrate.work);
 }
 
 static int
@@ -961,18 +1271,18 @@ static void
 nouveau_svm_fault_buffer_dtor(struct nouveau_svm *svm, int id)
 {
 	struct nouveau_svm_fault_buffer *buffer = &svm->buffer[id];
-	int i;
 
 	if (!nvif_object_constructed(&buffer->object))
 		return;
 
 	nouveau_svm_fault_buffer_fini(svm, id);
 
-	if (buffer->fault) {
-		for (i = 0; buffer->fault[i] && i < buffer->entries; i++)
-			kfree(buffer->fault[i]);
-		kvfree(buffer->fault);
-	}
+	kvfree(buffer->entry);
+	kvfree(buffer->faults);
+	kvfree(buffer->fault);
+	kvfree(buffer->hmm_req);
+	kvfree(buffer->hmm_pfns);
+	kvfree(buffer->args);
 
 	nvif_event_dtor(&buffer->notify);
 	nvif_object_dtor(&buffer->object);
@@ -985,6 +1295,7 @@ nouveau_svm_fault_buffer_ctor(struct nouveau_svm *svm, s32 oclass, int id)
 	struct nouveau_drm *drm = svm->drm;
 	struct nvif_object *device = &drm->client.device.object;
 	struct nvif_clb069_v0 args = {};
+	unsigned long npages;
 	int ret;
 
 	buffer->id = id;
@@ -996,7 +1307,13 @@ nouveau_svm_fault_buffer_ctor(struct nouveau_svm *svm, s32 oclass, int id)
 		return ret;
 	}
 
-	nvif_object_map(&buffer->object, NULL, 0);
+	/* The fault handler copies entries straight out of the mapping. */
+	ret = nvif_object_map(&buffer->object, NULL, 0);
+	if (ret) {
+		SVM_ERR(svm, "Fault buffer map failed: %d", ret);
+		return ret;
+	}
+
 	buffer->entries = args.entries;
 	buffer->getaddr = args.get;
 	buffer->putaddr = args.put;
@@ -1008,7 +1325,17 @@ nouveau_svm_fault_buffer_ctor(struct nouveau_svm *svm, s32 oclass, int id)
 		return ret;
 
 	buffer->fault = kvcalloc(buffer->entries, sizeof(*buffer->fault), GFP_KERNEL);
-	if (!buffer->fault)
+	buffer->faults = kvcalloc(buffer->entries, sizeof(*buffer->faults), GFP_KERNEL);
+	buffer->entry = kvcalloc(buffer->entries, 0x20, GFP_KERNEL);
+	if (!buffer->fault || !buffer->faults || !buffer->entry)
+		return -ENOMEM;
+
+	/* Space to handle a fault window of the maximum size. */
+	npages = svm->window.max >> PAGE_SHIFT;
+	buffer->args = kvzalloc(struct_size(buffer->args, p.phys, npages), GFP_KERNEL);
+	buffer->hmm_pfns = kvcalloc(npages, sizeof(*buffer->hmm_pfns), GFP_KERNEL);
+	buffer->hmm_req = kvcalloc(npages, sizeof(*buffer->hmm_req), GFP_KERNEL);
+	if (!buffer->args || !buffer->hmm_pfns || !buffer->hmm_req)
 		return -ENOMEM;
 
 	return nouveau_svm_fault_buffer_init(svm, id);
@@ -1026,8 +1353,10 @@ void
 nouveau_svm_suspend(struct nouveau_drm *drm)
 {
 	struct nouveau_svm *svm = drm->svm;
-	if (svm)
+	if (svm) {
 		nouveau_svm_fault_buffer_fini(svm, 0);
+		flush_work(&svm->migrate.work);
+	}
 }
 
 void
@@ -1036,6 +1365,7 @@ nouveau_svm_fini(struct nouveau_drm *drm)
 	struct nouveau_svm *svm = drm->svm;
 	if (svm) {
 		nouveau_svm_fault_buffer_dtor(svm, 0);
+		cancel_work_sync(&svm->migrate.work);
 		kfree(drm->svm);
 		drm->svm = NULL;
 	}
@@ -1065,7 +1395,18 @@ nouveau_svm_init(struct nouveau_drm *drm)
 
 	drm->svm->drm = drm;
 	mutex_init(&drm->svm->mutex);
-	INIT_LIST_HEAD(&drm->svm->inst);
+	hash_init(drm->svm->inst);
+	spin_lock_init(&svm->migrate.lock);
+	INIT_WORK(&svm->migrate.work, nouveau_svm_migrate_work);
+	init_waitqueue_head(&svm->migrate.wait);
+
+	/* Fault windows are a power-of-two size, starting at the GPU's
+	 * large page size and growing up to the module parameter limit
+	 * for sequential access streams.
+	 */
+	svm->window.max = clamp_t(u32, nouveau_svm_window, 4, SZ_2K) * SZ_1K;
+	svm->window.max = max_t(u32, rounddown_pow_of_two(svm->window.max), PAGE_SIZE);
+	svm->window.min = min_t(u32, NOUVEAU_SVM_WINDOW_MIN, svm->window.max);
 
 	ret = nvif_mclass(&drm->client.device.object, buffers);
 	if (ret < 0) {
@@ -14,6 +14,21 @@ struct nouveau_svmm {
 		unsigned long limit;
 	} unmanaged;
 
+	/* Fault window state, only touched by the fault handler. */
+	struct {
+		u64 next;
+		u32 window;
+	} fault;
+
+	/* Recent GPU fault counts per-region, also only touched by the
+	 * fault handler.
+	 */
+	struct nouveau_svmm_hot {
+		u64 addr;
+		u32 count;
+		unsigned long stamp;
+	} hot[16];
+
 	struct mutex mutex;
 };
 
@@ -107,36 +107,38 @@ nouveau_uvmm_vmm_sparse_unref(struct nouveau_uvmm *uvmm,
 
 static int
 nouveau_uvmm_vmm_get(struct nouveau_uvmm *uvmm,
-		     u64 addr, u64 range)
+		     u64 addr, u64 range, u8 page_shift)
 {
 	struct nvif_vmm *vmm = &uvmm->vmm.vmm;
 
-	return nvif_vmm_raw_get(vmm, addr, range, PAGE_SHIFT);
+	return nvif_vmm_raw_get(vmm, addr, range, page_shift);
 }
 
 static int
 nouveau_uvmm_vmm_put(struct nouveau_uvmm *uvmm,
-		     u64 addr, u64 range)
+		     u64 addr, u64 range, u8 page_shift)
 {
 	struct nvif_vmm *vmm = &uvmm->vmm.vmm;
 
-	return nvif_vmm_raw_put(vmm, addr, range, PAGE_SHIFT);
+	return nvif_vmm_raw_put(vmm, addr, range, page_shift);
 }
 
 static int
 nouveau_uvmm_vmm_unmap(struct nouveau_uvmm *uvmm,
-		       u64 addr, u64 range, bool sparse)
+		       u64 addr, u64 range, u8 page_shift, bool sparse,
+		       bool defer)
 {
 	struct nvif_vmm *vmm = &uvmm->vmm.vmm;
 
-	return nvif_vmm_raw_unmap(vmm, addr, range, PAGE_SHIFT, sparse);
+	return nvif_vmm_raw_unmap(vmm, addr, range, page_shift, sparse,
+				  defer);
 }
 
 static int
 nouveau_uvmm_vmm_map(struct nouveau_uvmm *uvmm,
-		     u64 addr, u64 range,
+		     u64 addr, u64 range, u8 page_shift,
 		     u64 bo_offset, u8 kind,
-		     struct nouveau_mem *mem)
+		     struct nouveau_mem *mem, bool defer)
 {
 	struct nvif_vmm *vmm = &uvmm->vmm.vmm;
 	union {
@@ -163,9 +165,17 @@ nouveau_uvmm_vmm_map(struct nouveau_uvmm *uvmm,
 		return -ENOSYS;
 	}
 
-	return nvif_vmm_raw_map(vmm, addr, range, PAGE_SHIFT,
+	return nvif_vmm_raw_map(vmm, addr, range, page_shift,
 				&args, argc,
-				&mem->mem, bo_offset);
+				&mem->mem, bo_offset, defer);
+}
+
+static int
+nouveau_uvmm_vmm_flush(struct nouveau_uvmm *uvmm)
+{
+	struct nvif_vmm *vmm = &uvmm->vmm.vmm;
+
+	return nvif_vmm_raw_flush(vmm);
 }
 
 static int
@@ -177,29 +187,41 @@ nouveau_uvma_region_sparse_unref(struct nouveau_uvma_region *reg)
 	return nouveau_uvmm_vmm_sparse_unref(reg->uvmm, addr, range);
 }
 
+static int
+nouveau_uvma_vmm_get(struct nouveau_uvma *uvma)
+{
+	u64 addr = uvma->va.va.addr;
+	u64 range = uvma->va.va.range;
+
+	return nouveau_uvmm_vmm_get(to_uvmm(uvma), addr, range,
+				    uvma->page_shift);
+}
+
 static int
 nouveau_uvma_vmm_put(struct nouveau_uvma *uvma)
 {
 	u64 addr = uvma->va.va.addr;
 	u64 range = uvma->va.va.range;
 
-	return nouveau_uvmm_vmm_put(to_uvmm(uvma), addr, range);
+	return nouveau_uvmm_vmm_put(to_uvmm(uvma), addr, range,
+				    uvma->page_shift);
 }
 
 static int
 nouveau_uvma_map(struct nouveau_uvma *uvma,
-		 struct nouveau_mem *mem)
+		 struct nouveau_mem *mem, bool defer)
 {
 	u64 addr = uvma->va.va.addr;
 	u64 offset = uvma->va.gem.offset;
 	u64 range = uvma->va.va.range;
 
 	return nouveau_uvmm_vmm_map(to_uvmm(uvma), addr, range,
-				    offset, uvma->kind, mem);
+				    uvma->page_shift, offset, uvma->kind,
+				    mem, defer);
 }
 
 static int
-nouveau_uvma_unmap(struct nouveau_uvma *uvma)
+nouveau_uvma_unmap(struct nouveau_uvma *uvma, bool defer)
 {
 	u64 addr = uvma->va.va.addr;
 	u64 range = uvma->va.va.range;
@@ -208,7 +230,8 @@ nouveau_uvma_unmap(struct nouveau_uvma *uvma)
 	if (drm_gpuva_invalidated(&uvma->va))
 		return 0;
 
-	return nouveau_uvmm_vmm_unmap(to_uvmm(uvma), addr, range, sparse);
+	return nouveau_uvmm_vmm_unmap(to_uvmm(uvma), addr, range,
+				      uvma->page_shift, sparse, defer);
 }
 
 static int
@@ -435,6 +458,93 @@ nouveau_uvma_region_complete(struct nouveau_uvma_region *reg)
 	complete_all(&reg->complete);
 }
 
+/*
+ * Page table references:
+ *
+ * Every mapping holds references on the page tables backing its VA range,
+ * taken at the page size it is mapped with.
+ *
+ * When a mapping is split by a remap, a remaining piece that can still be
+ * mapped with the original page size inherits the references (and PTEs) of
+ * the original mapping for its range.  Pieces that can't, as the split point
+ * isn't aligned to the original page size, take new references at their own
+ * page size and are mapped again from scratch.
+ *
+ * References held by removed mappings, or the removed parts of split
+ * mappings, are dropped during cleanup, once the new mappings are in place.
+ */
+
+static bool
+op_map_aligned_to_page_shift(const struct drm_gpuva_op_map *op, u8 page_shift)
+{
+	u64 non_page_bits = (1ULL << page_shift) - 1;
+
+	return (op->va.addr & non_page_bits) == 0 &&
+	       (op->va.range & non_page_bits) == 0 &&
+	       (op->gem.offset & non_page_bits) == 0;
+}
+
+/* Select the largest page size a mapping can be built from.
+ *
+ * This is bounded by the page size the BO's backing memory is allocated
+ * with, which nouveau_bo_alloc() chose to be valid for every domain the BO
+ * may be placed in, and by the alignment of the VA range and BO offset.
+ */
+static u8
+select_page_shift(struct nouveau_uvmm *uvmm, struct drm_gpuva_op_map *op)
+{
+	struct nouveau_bo *nvbo = nouveau_gem_object(op->gem.obj);
+	struct nvif_vmm *vmm = &uvmm->vmm.vmm;
+	int i;
+
+	for (i = 0; i < vmm->page_nr; i++) {
+		u8 shift = vmm->page[i].shift;
+
+		if (shift > nvbo->page || shift < PAGE_SHIFT)
+			continue;
+
+		/* Skip page sizes that can't support the BO's domains. */
+		if ((nvbo->valid_domains & NOUVEAU_GEM_DOMAIN_VRAM) &&
+		    !vmm->page[i].vram)
+			continue;
+		if ((nvbo->valid_domains & NOUVEAU_GEM_DOMAIN_GART) &&
+		    (!vmm->page[i].host || shift > PAGE_SHIFT))
+			continue;
+
+		if (op_map_aligned_to_page_shift(op, shift))
+			return shift;
+	}
+
+	return PAGE_SHIFT;
+}
+
+/* Whether a piece of a split mapping keeps the original's PTEs. */
+static bool
+op_remap_keep(struct drm_gpuva_op_remap *r, struct nouveau_uvma *piece)
+{
+	return piece->page_shift == uvma_from_va(r->unmap->va)->page_shift;
+}
+
+/* Range of the original mapping that doesn't survive a remap. */
+static void
+op_remap_range(struct drm_gpuva_op_remap *r,
+	       struct nouveau_uvma_prealloc *new,
+	       u64 *paddr, u64 *pend)
+{
+	struct drm_gpuva *va = r->unmap->va;
+	u64 addr = va->va.addr;
+	u64 end = va->va.addr + va->va.range;
+
+	if (r->prev && op_remap_keep(r, new->prev))
+		addr = r->prev->va.addr + r->prev->va.range;
+
+	if (r->next && op_remap_keep(r, new->next))
+		end = r->next->va.addr;
+
+	*paddr = addr;
+	*pend = end;
+}
+
 static void
 op_map_prepare_unwind(struct nouveau_uvma *uvma)
 {
@@ -450,21 +560,31 @@ op_unmap_prepare_unwind(struct drm_gpuva *va)
 	drm_gpuva_insert(va->vm, va);
 }
 
+/* Undo op_map_prepare() for a piece of a split mapping, including the
+ * page table references it took if it didn't inherit the original's.
+ */
+static void
+op_remap_prepare_unwind(struct drm_gpuva_op_remap *r,
+			struct nouveau_uvma *piece)
+{
+	if (!op_remap_keep(r, piece))
+		nouveau_uvma_vmm_put(piece);
+	op_map_prepare_unwind(piece);
+}
+
 static void
 nouveau_uvmm_sm_prepare_unwind(struct nouveau_uvmm *uvmm,
 			       struct nouveau_uvma_prealloc *new,
 			       struct drm_gpuva_ops *ops,
-			       struct drm_gpuva_op *last,
-			       struct uvmm_map_args *args)
+			       struct drm_gpuva_op *last)
 {
 	struct drm_gpuva_op *op = last;
-	u64 vmm_get_start = args ? args->addr : 0;
-	u64 vmm_get_end = args ? args->addr + args->range : 0;
 
-	/* Unwind GPUVA space. */
+	/* Unwind GPUVA space, and drop any page table references taken. */
 	drm_gpuva_for_each_op_from_reverse(op, ops) {
 		switch (op->op) {
 		case DRM_GPUVA_OP_MAP:
+			nouveau_uvma_vmm_put(new->map);
 			op_map_prepare_unwind(new->map);
 			break;
 		case DRM_GPUVA_OP_REMAP: {
@@ -472,10 +592,10 @@ nouveau_uvmm_sm_prepare_unwind(struct nouveau_uvmm *uvmm,
 			struct drm_gpuva *va = r->unmap->va;
 
 			if (r->next)
-				op_map_prepare_unwind(new->next);
+				op_remap_prepare_unwind(r, new->next);
 
 			if (r->prev)
-				op_map_prepare_unwind(new->prev);
+				op_remap_prepare_unwind(r, new->prev);
 
 			op_unmap_prepare_unwind(va);
 			break;
@@ -487,84 +607,16 @@ nouveau_uvmm_sm_prepare_unwind(struct nouveau_uvmm *uvmm,
 			break;
 		}
 	}
-
-	/* Unmap operation don't allocate page tables, hence skip the following
-	 * page table unwind.
-	 */
-	if (!args)
-		return;
-
-	drm_gpuva_for_each_op(op, ops) {
-		switch (op->op) {
-		case DRM_GPUVA_OP_MAP: {
-			u64 vmm_get_range = vmm_get_end - vmm_get_start;
-
-			if (vmm_get_range)
-				nouveau_uvmm_vmm_put(uvmm, vmm_get_start,
-						     vmm_get_range);
-			break;
-		}
-		case DRM_GPUVA_OP_REMAP: {
-			struct drm_gpuva_op_remap *r = &op->remap;
-			struct drm_gpuva *va = r->unmap->va;
-			u64 ustart = va->va.addr;
-			u64 urange = va->va.range;
-			u64 uend = ustart + urange;
-
-			if (r->prev)
-				vmm_get_start = uend;
-
-			if (r->next)
-				vmm_get_end = ustart;
-
-			if (r->prev && r->next)
-				vmm_get_start = vmm_get_end = 0;
-
-			break;
-		}
-		case DRM_GPUVA_OP_UNMAP: {
-			struct drm_gpuva_op_unmap *u = &op->unmap;
-			struct drm_gpuva *va = u->va;
-			u64 ustart = va->va.addr;
-			u64 urange = va->va.range;
-			u64 uend = ustart + urange;
-
-			/* Nothing to do for mappings we merge with. */
-			if (uend == vmm_get_start ||
-			    ustart == vmm_get_end)
-				break;
-
-			if (ustart > vmm_get_start) {
-				u64 vmm_get_range = ustart - vmm_get_start;
-
-				nouveau_uvmm_vmm_put(uvmm, vmm_get_start,
-						     vmm_get_range);
-			}
-			vmm_get_start = uend;
-			break;
-		}
-		default:
-			break;
-		}
-
-		if (op == last)
-			break;
-	}
 }
 
 static void
 nouveau_uvmm_sm_map_prepare_unwind(struct nouveau_uvmm *uvmm,
 				   struct nouveau_uvma_prealloc *new,
-				   struct drm_gpuva_ops *ops,
-				   u64 addr, u64 range)
+				   struct drm_gpuva_ops *ops)
 {
 	struct drm_gpuva_op *last = drm_gpuva_last_op(ops);
-	struct uvmm_map_args args = {
-		.addr = addr,
-		.range = range,
-	};
 
-	nouveau_uvmm_sm_prepare_unwind(uvmm, new, ops, last, &args);
+	nouveau_uvmm_sm_prepare_unwind(uvmm, new, ops, last);
 }
 
 static void
@@ -574,14 +626,15 @@ nouveau_uvmm_sm_unmap_prepare_unwind(struct nouveau_uvmm *uvmm,
 {
 	struct drm_gpuva_op *last = drm_gpuva_last_op(ops);
 
-	nouveau_uvmm_sm_prepare_unwind(uvmm, new, ops, last, NULL);
+	nouveau_uvmm_sm_prepare_unwind(uvmm, new, ops, last);
 }
 
 static int
 op_map_prepare(struct nouveau_uvmm *uvmm,
 	       struct nouveau_uvma **puvma,
 	       struct drm_gpuva_op_map *op,
-	       struct uvmm_map_args *args)
+	       struct uvmm_map_args *args,
+	       u8 page_shift)
 {
 	struct nouveau_uvma *uvma;
 	int ret;
@@ -592,6 +645,7 @@ op_map_prepare(struct nouveau_uvmm *uvmm,
 
 	uvma->region = args->region;
 	uvma->kind = args->kind;
+	uvma->page_shift = page_shift;
 
 	drm_gpuva_map(&uvmm->base, &uvma->va, op);
 
@@ -608,6 +662,39 @@ op_unmap_prepare(struct drm_gpuva_op_unmap *u)
 	drm_gpuva_unmap(u);
 }
 
+/* Prepare one piece of a split mapping.  It keeps the original's page size
+ * (and with it, the original's PTEs and page table references) if it's
+ * still aligned to it, otherwise it gets rebuilt at a smaller page size.
+ */
+static int
+op_remap_prepare(struct nouveau_uvmm *uvmm,
+		 struct nouveau_uvma **puvma,
+		 struct drm_gpuva_op_remap *r,
+		 struct drm_gpuva_op_map *op,
+		 struct uvmm_map_args *args)
+{
+	struct nouveau_uvma *uvma = uvma_from_va(r->unmap->va);
+	u8 page_shift = uvma->page_shift;
+	int ret;
+
+	if (!op_map_aligned_to_page_shift(op, page_shift))
+		page_shift = select_page_shift(uvmm, op);
+
+	ret = op_map_prepare(uvmm, puvma, op, args, page_shift);
+	if (ret)
+		return ret;
+
+	if (page_shift != uvma->page_shift) {
+		ret = nouveau_uvma_vmm_get(*puvma);
+		if (ret) {
+			op_map_prepare_unwind(*puvma);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
 /*
  * Note: @args should not be NULL when calling for a map operation.
  */
@@ -618,30 +705,23 @@ nouveau_uvmm_sm_prepare(struct nouveau_uvmm *uvmm,
 			struct uvmm_map_args *args)
 {
 	struct drm_gpuva_op *op;
-	u64 vmm_get_start = args ? args->addr : 0;
-	u64 vmm_get_end = args ? args->addr + args->range : 0;
 	int ret;
 
 	drm_gpuva_for_each_op(op, ops) {
 		switch (op->op) {
-		case DRM_GPUVA_OP_MAP: {
-			u64 vmm_get_range = vmm_get_end - vmm_get_start;
-
-			ret = op_map_prepare(uvmm, &new->map, &op->map, args);
+		case DRM_GPUVA_OP_MAP:
+			ret = op_map_prepare(uvmm, &new->map, &op->map, args,
+					     select_page_shift(uvmm, &op->map));
 			if (ret)
 				goto unwind;
 
-			if (vmm_get_range) {
-				ret = nouveau_uvmm_vmm_get(uvmm, vmm_get_start,
-							   vmm_get_range);
-				if (ret) {
-					op_map_prepare_unwind(new->map);
-					goto unwind;
-				}
+			ret = nouveau_uvma_vmm_get(new->map);
+			if (ret) {
+				op_map_prepare_unwind(new->map);
+				goto unwind;
 			}
 
 			break;
-		}
 		case DRM_GPUVA_OP_REMAP: {
 			struct drm_gpuva_op_remap *r = &op->remap;
 			struct drm_gpuva *va = r->unmap->va;
@@ -649,71 +729,34 @@ nouveau_uvmm_sm_prepare(struct nouveau_uvmm *uvmm,
 				.kind = uvma_from_va(va)->kind,
 				.region = uvma_from_va(va)->region,
 			};
-			u64 ustart = va->va.addr;
-			u64 urange = va->va.range;
-			u64 uend = ustart + urange;
 
 			op_unmap_prepare(r->unmap);
 
 			if (r->prev) {
-				ret = op_map_prepare(uvmm, &new->prev, r->prev,
-						     &remap_args);
-				if (ret)
-					goto unwind;
-
-				if (args)
-					vmm_get_start = uend;
-			}
-
-			if (r->next) {
-				ret = op_map_prepare(uvmm, &new->next, r->next,
-						     &remap_args);
+				ret = op_remap_prepare(uvmm, &new->prev, r,
+						       r->prev, &remap_args);
 				if (ret) {
-					if (r->prev)
-						op_map_prepare_unwind(new->prev);
+					op_unmap_prepare_unwind(va);
 					goto unwind;
 				}
-
-				if (args)
-					vmm_get_end = ustart;
 			}
 
-			if (args && (r->prev && r->next))
-				vmm_get_start = vmm_get_end = 0;
-
-			break;
-		}
-		case DRM_GPUVA_OP_UNMAP: {
-			struct drm_gpuva_op_unmap *u = &op->unmap;
-			struct drm_gpuva *va = u->va;
-			u64 ustart = va->va.addr;
-			u64 urange = va->va.range;
-			u64 uend = ustart + urange;
-
-			op_unmap_prepare(u);
-
-			if (!args)
-				break;
-
-			/* Nothing to do for mappings we merge with. */
-			if (uend == vmm_get_start ||
-			    ustart == vmm_get_end)
-				break;
-
-			if (ustart > vmm_get_start) {
-				u64 vmm_get_range = ustart - vmm_get_start;
-
-				ret = nouveau_uvmm_vmm_get(uvmm, vmm_get_start,
-							   vmm_get_range);
+			if (r->next) {
+				ret = op_remap_prepare(uvmm, &new->next, r,
+						       r->next, &remap_args);
 				if (ret) {
+					if (r->prev)
+						op_remap_prepare_unwind(r, new->prev);
 					op_unmap_prepare_unwind(va);
 					goto unwind;
 				}
 			}
-			vmm_get_start = uend;
 
 			break;
 		}
+		case DRM_GPUVA_OP_UNMAP:
+			op_unmap_prepare(&op->unmap);
+			break;
 		default:
 			ret = -EINVAL;
 			goto unwind;
@@ -725,8 +768,7 @@ nouveau_uvmm_sm_prepare(struct nouveau_uvmm *uvmm,
 unwind:
 	if (op != drm_gpuva_first_op(ops))
 		nouveau_uvmm_sm_prepare_unwind(uvmm, new, ops,
-					       drm_gpuva_prev_op(op),
-					       args);
+					       drm_gpuva_prev_op(op));
 	return ret;
 }
 
@@ -780,7 +822,7 @@ op_map(struct nouveau_uvma *uvma)
 {
 	struct nouveau_bo *nvbo = nouveau_gem_object(uvma->va.gem.obj);
 
-	nouveau_uvma_map(uvma, nouveau_mem(nvbo->bo.resource));
+	nouveau_uvma_map(uvma, nouveau_mem(nvbo->bo.resource), true);
 }
 
 static void
@@ -791,7 +833,7 @@ op_unmap(struct drm_gpuva_op_unmap *u)
 
 	/* nouveau_uvma_unmap() does not unmap if backing BO is evicted. */
 	if (!u->keep)
-		nouveau_uvma_unmap(uvma);
+		nouveau_uvma_unmap(uvma, true);
 }
 
 static void
@@ -802,25 +844,37 @@ op_unmap_range(struct drm_gpuva_op_unmap *u,
 	bool sparse = !!uvma->region;
 
 	if (!drm_gpuva_invalidated(u->va))
-		nouveau_uvmm_vmm_unmap(to_uvmm(uvma), addr, range, sparse);
+		nouveau_uvmm_vmm_unmap(to_uvmm(uvma), addr, range,
+				       uvma->page_shift, sparse, true);
+}
+
+/* Map a piece of a split mapping that couldn't keep the original's PTEs. */
+static void
+op_remap_map(struct drm_gpuva_op_remap *r, struct nouveau_uvma *piece)
+{
+	if (op_remap_keep(r, piece))
+		return;
+
+	if (drm_gpuva_invalidated(r->unmap->va))
+		drm_gpuva_invalidate(&piece->va, true);
+	else
+		op_map(piece);
 }
 
 static void
 op_remap(struct drm_gpuva_op_remap *r,
 	 struct nouveau_uvma_prealloc *new)
 {
-	struct drm_gpuva_op_unmap *u = r->unmap;
-	struct nouveau_uvma *uvma = uvma_from_va(u->va);
-	u64 addr = uvma->va.va.addr;
-	u64 end = uvma->va.va.addr + uvma->va.va.range;
+	u64 addr, end;
+
+	op_remap_range(r, new, &addr, &end);
+	op_unmap_range(r->unmap, addr, end - addr);
 
 	if (r->prev)
-		addr = r->prev->va.addr + r->prev->va.range;
+		op_remap_map(r, new->prev);
 
 	if (r->next)
-		end = r->next->va.addr;
-
-	op_unmap_range(u, addr, end - addr);
+		op_remap_map(r, new->next);
 }
 
 static int
@@ -868,7 +922,7 @@ nouveau_uvmm_sm_unmap(struct nouveau_uvmm *uvmm,
 static void
 nouveau_uvmm_sm_cleanup(struct nouveau_uvmm *uvmm,
 			struct nouveau_uvma_prealloc *new,
-			struct drm_gpuva_ops *ops, bool unmap)
+			struct drm_gpuva_ops *ops)
 {
 	struct drm_gpuva_op *op;
 
@@ -878,23 +932,14 @@ nouveau_uvmm_sm_cleanup(struct nouveau_uvmm *uvmm,
 			break;
 		case DRM_GPUVA_OP_REMAP: {
 			struct drm_gpuva_op_remap *r = &op->remap;
-			struct drm_gpuva_op_map *p = r->prev;
-			struct drm_gpuva_op_map *n = r->next;
 			struct drm_gpuva *va = r->unmap->va;
 			struct nouveau_uvma *uvma = uvma_from_va(va);
+			u64 addr, end;
 
-			if (unmap) {
-				u64 addr = va->va.addr;
-				u64 end = addr + va->va.range;
-
-				if (p)
-					addr = p->va.addr + p->va.range;
-
-				if (n)
-					end = n->va.addr;
-
-				nouveau_uvmm_vmm_put(uvmm, addr, end - addr);
-			}
+			op_remap_range(r, new, &addr, &end);
+			if (end > addr)
+				nouveau_uvmm_vmm_put(uvmm, addr, end - addr,
+						     uvma->page_shift);
 
 			nouveau_uvma_gem_put(uvma);
 			nouveau_uvma_free(uvma);
@@ -905,8 +950,7 @@ nouveau_uvmm_sm_cleanup(struct nouveau_uvmm *uvmm,
 			struct drm_gpuva *va = u->va;
 			struct nouveau_uvma *uvma = uvma_from_va(va);
 
-			if (unmap)
-				nouveau_uvma_vmm_put(uvma);
+			nouveau_uvma_vmm_put(uvma);
 
 			nouveau_uvma_gem_put(uvma);
 			nouveau_uvma_free(uvma);
@@ -923,7 +967,7 @@ nouveau_uvmm_sm_map_cleanup(struct nouveau_uvmm *uvmm,
 			    struct nouveau_uvma_prealloc *new,
 			    struct drm_gpuva_ops *ops)
 {
-	nouveau_uvmm_sm_cleanup(uvmm, new, ops, false);
+	nouveau_uvmm_sm_cleanup(uvmm, new, ops);
 }
 
 static void
@@ -931,7 +975,7 @@ nouveau_uvmm_sm_unmap_cleanup(struct nouveau_uvmm *uvmm,
 			      struct nouveau_uvma_prealloc *new,
 			      struct drm_gpuva_ops *ops)
 {
-	nouveau_uvmm_sm_cleanup(uvmm, new, ops, true);
+	nouveau_uvmm_sm_cleanup(uvmm, new, ops);
 }
 
 static int
@@ -1408,9 +1452,7 @@ unwind:
 			break;
 		case OP_MAP:
 			nouveau_uvmm_sm_map_prepare_unwind(uvmm, &op->new,
-							   op->ops,
-							   op->va.addr,
-							   op->va.range);
+							   op->ops);
 			break;
 		case OP_UNMAP:
 			nouveau_uvmm_sm_unmap_prepare_unwind(uvmm, &op->new,
@@ -1466,6 +1508,11 @@ nouveau_uvmm_bind_job_run(struct nouveau_job *job)
 	}
 
 out:
+	/* The page table updates above leave TLB invalidation to us, such
+	 * that a job performs a single one, rather than one per operation.
+	 */
+	nouveau_uvmm_vmm_flush(uvmm);
+
 	if (ret)
 		NV_PRINTK(err, job->cli, "bind job failed: %d\n", ret);
 	return ERR_PTR(ret);
@@ -1765,7 +1812,7 @@ nouveau_uvmm_bo_map_all(struct nouveau_bo *nvbo, struct nouveau_mem *mem)
 		drm_gpuvm_bo_for_each_va(va, vm_bo) {
 			struct nouveau_uvma *uvma = uvma_from_va(va);
 
-			nouveau_uvma_map(uvma, mem);
+			nouveau_uvma_map(uvma, mem, false);
 			drm_gpuva_invalidate(va, false);
 		}
 	}
@@ -1784,7 +1831,7 @@ nouveau_uvmm_bo_unmap_all(struct nouveau_bo *nvbo)
 		drm_gpuvm_bo_for_each_va(va, vm_bo) {
 			struct nouveau_uvma *uvma = uvma_from_va(va);
 
-			nouveau_uvma_unmap(uvma);
+			nouveau_uvma_unmap(uvma, false);
 			drm_gpuva_invalidate(va, true);
 		}
 	}
@@ -1909,7 +1956,7 @@ nouveau_uvmm_fini(struct nouveau_uvmm *uvmm)
 		drm_gpuva_unlink(va);
 		dma_resv_unlock(obj->resv);
 
-		nouveau_uvma_unmap(uvma);
+		nouveau_uvma_unmap(uvma, false);
 		nouveau_uvma_vmm_put(uvma);
 
 		nouveau_uvma_gem_put(uvma);
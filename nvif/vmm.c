@@ -137,7 +137,8 @@ nvif_vmm_raw_put(struct nvif_vmm *vmm, u64 addr, u64 size, u8 shift)
 
 int
 nvif_vmm_raw_map(struct nvif_vmm *vmm, u64 addr, u64 size, u8 shift,
-		 void *argv, u32 argc, struct nvif_mem *mem, u64 offset)
+		 void *argv, u32 argc, struct nvif_mem *mem, u64 offset,
+		 bool defer)
 {
 	struct nvif_vmm_raw_v0 args = {
 		.version = 0,
@@ -149,6 +150,7 @@ nvif_vmm_raw_map(struct nvif_vmm *vmm, u64 addr, u64 size, u8 shift,
 		.offset = offset,
 		.argv = (u64)(uintptr_t)argv,
 		.argc = argc,
+		.defer = defer,
 	};
 
 
@@ -158,7 +160,7 @@ nvif_vmm_raw_map(struct nvif_vmm *vmm, u64 addr, u64 size, u8 shift,
 
 int
 nvif_vmm_raw_unmap(struct nvif_vmm *vmm, u64 addr, u64 size,
-		   u8 shift, bool sparse)
+		   u8 shift, bool sparse, bool defer)
 {
 	struct nvif_vmm_raw_v0 args = {
 		.version = 0,
@@ -167,6 +169,7 @@ nvif_vmm_raw_unmap(struct nvif_vmm *vmm, u64 addr, u64 size,
 		.size = size,
 		.shift = shift,
 		.sparse = sparse,
+		.defer = defer,
 	};
 
 	return nvif_object_mthd(&vmm->object, NVIF_VMM_V0_RAW,
@@ -188,6 +191,18 @@ nvif_vmm_raw_sparse(struct nvif_vmm *vmm, u64 addr, u64 size, bool ref)
 				&args, sizeof(args));
 }
 
+int
+nvif_vmm_raw_flush(struct nvif_vmm *vmm)
+{
+	struct nvif_vmm_raw_v0 args = {
+		.version = 0,
+		.op = NVIF_VMM_RAW_V0_FLUSH,
+	};
+
+	return nvif_object_mthd(&vmm->object, NVIF_VMM_V0_RAW,
+				&args, sizeof(args));
+}
+
 void
 nvif_vmm_dtor(struct nvif_vmm *vmm)
 {
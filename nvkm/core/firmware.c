@@ -25,6 +25,177 @@
 #include <subdev/fb.h>
 #include <subdev/mmu.h>
 
+#include <linux/async.h>
+
+/* Firmware images are cached per-device, and shared between all users of
+ * the same file.  An image is released when its last user is done with it,
+ * except for prefetched images, which the cache holds onto ("pinned") until
+ * their first user claims them, or the device is destroyed.
+ */
+struct nvkm_firmware_cache {
+	struct list_head head;
+	struct kref kref;
+	struct completion done;
+	struct nvkm_device *device;
+	const struct firmware *blob;
+	struct firmware fw;
+	bool pinned;
+	char path[64];
+};
+
+/* Every file loaded for a device is logged, so what was loaded (and when)
+ * can still be reported once the cache has let go of it.
+ */
+struct nvkm_firmware_log {
+	struct list_head head;
+	size_t size;
+	ktime_t loaded;
+	u32 load_us;
+	char path[64];
+};
+
+static ASYNC_DOMAIN_EXCLUSIVE(nvkm_firmware_async);
+
+/* Called with device->fw.mutex held, which is dropped. */
+static void
+nvkm_firmware_cache_del(struct kref *kref)
+{
+	struct nvkm_firmware_cache *fwc = container_of(kref, typeof(*fwc), kref);
+
+	list_del(&fwc->head);
+	mutex_unlock(&fwc->device->fw.mutex);
+
+	release_firmware(fwc->blob);
+	kfree(fwc);
+}
+
+static void
+nvkm_firmware_cache_put(struct nvkm_firmware_cache *fwc)
+{
+	kref_put_mutex(&fwc->kref, nvkm_firmware_cache_del, &fwc->device->fw.mutex);
+}
+
+static void
+nvkm_firmware_path(struct nvkm_device *device, const char *fwname, int ver,
+		   char *path, int size)
+{
+	char cname[16];
+	int i;
+
+	/* Convert device name to lowercase */
+	strscpy(cname, device->chip->name, sizeof(cname));
+	i = strlen(cname);
+	while (i) {
+		--i;
+		cname[i] = tolower(cname[i]);
+	}
+
+	if (ver != 0)
+		snprintf(path, size, "nvidia/%s/%s-%d.bin", cname, fwname, ver);
+	else
+		snprintf(path, size, "nvidia/%s/%s.bin", cname, fwname);
+}
+
+/* Look up 'path' in the cache, creating a pending entry for it if it isn't
+ * present.  Returns with a reference held on the entry, and *pnew set if
+ * the caller is responsible for requesting the file.
+ */
+static struct nvkm_firmware_cache *
+nvkm_firmware_cache_get(struct nvkm_device *device, const char *path, bool pin,
+			bool *pnew)
+{
+	struct nvkm_firmware_cache *fwc;
+
+	mutex_lock(&device->fw.mutex);
+	list_for_each_entry(fwc, &device->fw.list, head) {
+		if (!strcmp(fwc->path, path)) {
+			/* First user of a prefetched image inherits the
+			 * cache's reference.
+			 */
+			if (fwc->pinned && !pin)
+				fwc->pinned = false;
+			else
+				kref_get(&fwc->kref);
+			mutex_unlock(&device->fw.mutex);
+			*pnew = false;
+			return fwc;
+		}
+	}
+
+	fwc = kzalloc(sizeof(*fwc), GFP_KERNEL);
+	if (fwc) {
+		kref_init(&fwc->kref);
+		if (pin) {
+			kref_get(&fwc->kref);
+			fwc->pinned = true;
+		}
+		init_completion(&fwc->done);
+		fwc->device = device;
+		strscpy(fwc->path, path, sizeof(fwc->path));
+		list_add_tail(&fwc->head, &device->fw.list);
+	}
+	mutex_unlock(&device->fw.mutex);
+	*pnew = true;
+	return fwc;
+}
+
+static void
+nvkm_firmware_log(struct nvkm_device *device, const char *path, size_t size,
+		  ktime_t loaded, u32 load_us)
+{
+	struct nvkm_firmware_log *log;
+
+	mutex_lock(&device->fw.mutex);
+	list_for_each_entry(log, &device->fw.log, head) {
+		if (!strcmp(log->path, path))
+			goto update;
+	}
+
+	log = kzalloc(sizeof(*log), GFP_KERNEL);
+	if (!log)
+		goto done;
+
+	strscpy(log->path, path, sizeof(log->path));
+	list_add_tail(&log->head, &device->fw.log);
+update:
+	log->size = size;
+	log->loaded = loaded;
+	log->load_us = load_us;
+done:
+	mutex_unlock(&device->fw.mutex);
+}
+
+static void
+nvkm_firmware_cache_load(struct nvkm_firmware_cache *fwc)
+{
+	struct nvkm_device *device = fwc->device;
+	ktime_t time = ktime_get();
+	bool unpin = false;
+
+	if (!firmware_request_nowarn(&fwc->blob, fwc->path, device->dev)) {
+		ktime_t loaded = ktime_get();
+
+		fwc->fw.size = fwc->blob->size;
+		fwc->fw.data = fwc->blob->data;
+		nvkm_firmware_log(device, fwc->path, fwc->fw.size, loaded,
+				  ktime_us_delta(loaded, time));
+	} else {
+		/* Don't cache failures, the file may be installed later. */
+		fwc->blob = NULL;
+		mutex_lock(&device->fw.mutex);
+		list_del_init(&fwc->head);
+		unpin = fwc->pinned;
+		fwc->pinned = false;
+		mutex_unlock(&device->fw.mutex);
+	}
+
+	complete_all(&fwc->done);
+
+	/* Caller still holds a reference, so this won't free the entry. */
+	if (unpin)
+		nvkm_firmware_cache_put(fwc);
+}
+
 int
 nvkm_firmware_load_name(const struct nvkm_subdev *subdev, const char *base,
 			const char *name, int ver, const struct firmware **pfw)
@@ -74,29 +245,29 @@ nvkm_firmware_get(const struct nvkm_subdev *subdev, const char *fwname, int ver,
 		  const struct firmware **fw)
 {
 	struct nvkm_device *device = subdev->device;
+	struct nvkm_firmware_cache *fwc;
 	char f[64];
-	char cname[16];
-	int i;
+	bool new;
 
-	/* Convert device name to lowercase */
-	strscpy(cname, device->chip->name, sizeof(cname));
-	i = strlen(cname);
-	while (i) {
-		--i;
-		cname[i] = tolower(cname[i]);
-	}
+	nvkm_firmware_path(device, fwname, ver, f, sizeof(f));
 
-	if (ver != 0)
-		snprintf(f, sizeof(f), "nvidia/%s/%s-%d.bin", cname, fwname, ver);
+	fwc = nvkm_firmware_cache_get(device, f, false, &new);
+	if (!fwc)
+		return -ENOMEM;
+
+	if (new)
+		nvkm_firmware_cache_load(fwc);
 	else
-		snprintf(f, sizeof(f), "nvidia/%s/%s.bin", cname, fwname);
+		wait_for_completion(&fwc->done);
 
-	if (!firmware_request_nowarn(fw, f, device->dev)) {
-		nvkm_debug(subdev, "firmware \"%s\" loaded - %zu byte(s)\n",
-			   f, (*fw)->size);
+	if (fwc->blob) {
+		nvkm_debug(subdev, "firmware \"%s\" %s - %zu byte(s)\n",
+			   f, new ? "loaded" : "cached", fwc->fw.size);
+		*fw = &fwc->fw;
 		return 0;
 	}
 
+	nvkm_firmware_cache_put(fwc);
 	nvkm_debug(subdev, "firmware \"%s\" unavailable\n", f);
 	return -ENOENT;
 }
@@ -107,7 +278,170 @@ nvkm_firmware_get(const struct nvkm_subdev *subdev, const char *fwname, int ver,
 void
 nvkm_firmware_put(const struct firmware *fw)
 {
-	release_firmware(fw);
+	if (fw) {
+		struct nvkm_firmware_cache *fwc = container_of(fw, typeof(*fwc), fw);
+
+		nvkm_firmware_cache_put(fwc);
+	}
+}
+
+/* Files requested by the ACR-based boot path on GM20x-GV100 (non-Tegra).
+ * Later GPUs may boot via GSP-RM instead, so their needs aren't known
+ * until the GSP subdev has been constructed.
+ */
+static const char *const
+nvkm_firmware_prefetch_gm200[] = {
+	"acr/bl",
+	"acr/ucode_load",
+	"acr/ucode_unload",
+	"gr/fecs_bl",
+	"gr/fecs_inst",
+	"gr/fecs_data",
+	"gr/fecs_sig",
+	"gr/gpccs_bl",
+	"gr/gpccs_inst",
+	"gr/gpccs_data",
+	"gr/gpccs_sig",
+	"gr/sw_ctx",
+	"gr/sw_nonctx",
+	"gr/sw_bundle_init",
+	"gr/sw_method_init",
+	NULL
+};
+
+static void
+nvkm_firmware_prefetch_one(void *data, async_cookie_t cookie)
+{
+	struct nvkm_firmware_cache *fwc = data;
+
+	nvkm_firmware_cache_load(fwc);
+	if (fwc->blob)
+		nvdev_trace(fwc->device, "firmware \"%s\" prefetched\n", fwc->path);
+	nvkm_firmware_put(&fwc->fw);
+}
+
+/**
+ * nvkm_firmware_prefetch - start loading the firmware a chip is known to need
+ * @device:	device to load firmware for
+ *
+ * Requests are issued asynchronously; nvkm_firmware_get() waits for any
+ * that are still in flight.
+ */
+void
+nvkm_firmware_prefetch(struct nvkm_device *device)
+{
+	const char *const *name = NULL;
+	char f[64];
+	bool new;
+
+	if (device->chipset >= 0x120 && device->card_type < TU100 && !device->func->tegra)
+		name = nvkm_firmware_prefetch_gm200;
+
+	for (; name && *name; name++) {
+		struct nvkm_firmware_cache *fwc;
+
+		nvkm_firmware_path(device, *name, 0, f, sizeof(f));
+
+		fwc = nvkm_firmware_cache_get(device, f, true, &new);
+		if (!fwc)
+			break;
+
+		if (!new) {
+			nvkm_firmware_put(&fwc->fw);
+			continue;
+		}
+
+		async_schedule_domain(nvkm_firmware_prefetch_one, fwc, &nvkm_firmware_async);
+	}
+}
+
+/**
+ * nvkm_firmware_log_foreach - visit each firmware file loaded for a device
+ * @device:	device the firmware was loaded for
+ * @func:	called with the path, size and load time of each file
+ * @priv:	passed through to @func
+ *
+ * Files are reported whether or not they're still loaded.  Iteration stops
+ * at the first non-zero return from @func, which is passed back to the
+ * caller.
+ */
+int
+nvkm_firmware_log_foreach(struct nvkm_device *device,
+			  int (*func)(void *priv, const char *path, size_t size,
+				      ktime_t loaded, u32 load_us),
+			  void *priv)
+{
+	struct nvkm_firmware_log *log;
+	int ret = 0;
+
+	mutex_lock(&device->fw.mutex);
+	list_for_each_entry(log, &device->fw.log, head) {
+		ret = func(priv, log->path, log->size, log->loaded, log->load_us);
+		if (ret)
+			break;
+	}
+	mutex_unlock(&device->fw.mutex);
+	return ret;
+}
+
+/**
+ * nvkm_firmware_image_foreach - visit each firmware image a device holds
+ * @device:	device the images belong to
+ * @func:	called with the name and contents of each image
+ * @priv:	passed through to @func
+ *
+ * These are the copies made with nvkm_firmware_ctor() (GSP-RM, and falcon
+ * ucode such as ACR and GSP booter/FWSEC), as they're used by the driver.
+ * Images are locked against destruction while @func runs, their contents
+ * are only valid until it returns.  Iteration stops at the first non-zero
+ * return from @func, which is passed back to the caller.
+ */
+int
+nvkm_firmware_image_foreach(struct nvkm_device *device,
+			    int (*func)(void *priv, const char *name,
+					const void *data, size_t size),
+			    void *priv)
+{
+	struct nvkm_firmware *fw;
+	int ret = 0;
+
+	mutex_lock(&device->fw.mutex);
+	list_for_each_entry(fw, &device->fw.images, head) {
+		ret = func(priv, fw->name, fw->img, fw->len);
+		if (ret)
+			break;
+	}
+	mutex_unlock(&device->fw.mutex);
+	return ret;
+}
+
+void
+nvkm_firmware_cache_fini(struct nvkm_device *device)
+{
+	struct nvkm_firmware_cache *fwc, *fwt;
+	struct nvkm_firmware_log *log, *lwt;
+	LIST_HEAD(pinned);
+
+	async_synchronize_full_domain(&nvkm_firmware_async);
+
+	/* Drop the references held on prefetched images nobody claimed. */
+	mutex_lock(&device->fw.mutex);
+	list_for_each_entry_safe(fwc, fwt, &device->fw.list, head) {
+		list_del_init(&fwc->head);
+		if (fwc->pinned) {
+			fwc->pinned = false;
+			list_add_tail(&fwc->head, &pinned);
+		}
+	}
+	mutex_unlock(&device->fw.mutex);
+
+	list_for_each_entry_safe(fwc, fwt, &pinned, head)
+		nvkm_firmware_cache_put(fwc);
+
+	list_for_each_entry_safe(log, lwt, &device->fw.log, head) {
+		list_del(&log->head);
+		kfree(log);
+	}
 }
 
 #define nvkm_firmware_mem(p) container_of((p), struct nvkm_firmware, mem.memory)
@@ -199,6 +533,10 @@ nvkm_firmware_dtor(struct nvkm_firmware *fw)
 	if (!fw->img)
 		return;
 
+	mutex_lock(&fw->device->fw.mutex);
+	list_del(&fw->head);
+	mutex_unlock(&fw->device->fw.mutex);
+
 	switch (fw->func->type) {
 	case NVKM_FIRMWARE_IMG_RAM:
 		kfree(fw->img);
@@ -305,5 +643,9 @@ nvkm_firmware_ctor(const struct nvkm_firmware_func *func, const char *name,
 		return -ENOMEM;
 
 	nvkm_memory_ctor(&nvkm_firmware_mem, &fw->mem.memory);
+
+	mutex_lock(&device->fw.mutex);
+	list_add_tail(&fw->head, &device->fw.images);
+	mutex_unlock(&device->fw.mutex);
 	return 0;
 }
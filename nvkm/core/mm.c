@@ -157,6 +157,18 @@ nvkm_mm_head(struct nvkm_mm *mm, u8 heap, u8 type, u32 size_max, u32 size_min,
 	return -ENOSPC;
 }
 
+/* Split the first 'size' units off an allocated node, returning them as a
+ * new node (or the node itself, if it's exactly 'size' units long).
+ */
+struct nvkm_mm_node *
+nvkm_mm_split(struct nvkm_mm *mm, struct nvkm_mm_node *node, u32 size)
+{
+	if (WARN_ON(node->type == NVKM_MM_TYPE_NONE || size > node->length))
+		return NULL;
+
+	return region_head(mm, node, size);
+}
+
 static struct nvkm_mm_node *
 region_tail(struct nvkm_mm *mm, struct nvkm_mm_node *a, u32 size)
 {
@@ -23,6 +23,12 @@
 #include <core/engine.h>
 #include <core/object.h>
 
+/* Slot states, stored in place of a channel ID.  DEAD marks a removed
+ * entry, which must still be probed past as it may be part of a chain.
+ */
+#define NVKM_RAMHT_FREE -1
+#define NVKM_RAMHT_DEAD -2
+
 static u32
 nvkm_ramht_hash(struct nvkm_ramht *ramht, int chid, u32 handle)
 {
@@ -49,6 +55,10 @@ nvkm_ramht_search(struct nvkm_ramht *ramht, int chid, u32 handle)
 				return ramht->data[co].inst;
 		}
 
+		/* Never-used slot, so the handle can't be further along. */
+		if (ramht->data[co].chid == NVKM_RAMHT_FREE)
+			break;
+
 		if (++co >= ramht->size)
 			co = 0;
 	} while (co != ho);
@@ -62,6 +72,8 @@ nvkm_ramht_update(struct nvkm_ramht *ramht, int co, struct nvkm_object *object,
 {
 	struct nvkm_ramht_data *data = &ramht->data[co];
 	u64 inst = 0x00000040; /* just non-zero for <=g8x fifo ramht */
+	int prev = data->chid;
+	u32 prev_handle = data->handle;
 	int ret;
 
 	nvkm_gpuobj_del(&data->inst);
@@ -72,7 +84,11 @@ nvkm_ramht_update(struct nvkm_ramht *ramht, int co, struct nvkm_object *object,
 		ret = nvkm_object_bind(object, ramht->parent, 16, &data->inst);
 		if (ret) {
 			if (ret != -ENODEV) {
-				data->chid = -1;
+				/* Leave the slot as it was, so a failed
+				 * insert doesn't lengthen probe chains.
+				 */
+				data->chid = prev;
+				data->handle = prev_handle;
 				return ret;
 			}
 			data->inst = NULL;
@@ -99,8 +115,29 @@ nvkm_ramht_update(struct nvkm_ramht *ramht, int co, struct nvkm_object *object,
 void
 nvkm_ramht_remove(struct nvkm_ramht *ramht, int cookie)
 {
-	if (--cookie >= 0)
-		nvkm_ramht_update(ramht, cookie, NULL, -1, 0, 0, 0);
+	int co;
+
+	if (--cookie < 0)
+		return;
+
+	nvkm_ramht_update(ramht, cookie, NULL, NVKM_RAMHT_DEAD, 0, 0, 0);
+	ramht->used--;
+
+	/* If this was the end of a chain, the dead slots leading up to it
+	 * can be returned to the free state to keep probe lengths short.
+	 */
+	co = cookie + 1;
+	if (co >= ramht->size)
+		co = 0;
+
+	if (ramht->data[co].chid != NVKM_RAMHT_FREE)
+		return;
+
+	for (co = cookie; ramht->data[co].chid == NVKM_RAMHT_DEAD; ) {
+		ramht->data[co].chid = NVKM_RAMHT_FREE;
+		if (--co < 0)
+			co = ramht->size - 1;
+	}
 }
 
 int
@@ -108,6 +145,7 @@ nvkm_ramht_insert(struct nvkm_ramht *ramht, struct nvkm_object *object,
 		  int chid, int addr, u32 handle, u32 context)
 {
 	u32 co, ho;
+	int probe = 0, ret;
 
 	if (nvkm_ramht_search(ramht, chid, handle))
 		return -EEXIST;
@@ -115,14 +153,31 @@ nvkm_ramht_insert(struct nvkm_ramht *ramht, struct nvkm_object *object,
 	co = ho = nvkm_ramht_hash(ramht, chid, handle);
 	do {
 		if (ramht->data[co].chid < 0) {
-			return nvkm_ramht_update(ramht, co, object, chid,
-						 addr, handle, context);
+			ret = nvkm_ramht_update(ramht, co, object, chid,
+						addr, handle, context);
+			if (ret < 0)
+				return ret;
+
+			if (probe > ramht->probe_max) {
+				ramht->probe_max = probe;
+				nvdev_trace(ramht->device, "ramht: %d/%d used, max probe %d\n",
+					    ramht->used + 1, ramht->size, probe);
+			}
+
+			if (++ramht->used * 4 == ramht->size * 3) {
+				nvdev_debug(ramht->device, "ramht: 75%% full (%d/%d), max probe %d\n",
+					    ramht->used, ramht->size, ramht->probe_max);
+			}
+
+			return ret;
 		}
 
+		probe++;
 		if (++co >= ramht->size)
 			co = 0;
 	} while (co != ho);
 
+	nvdev_debug(ramht->device, "ramht: full (%d/%d)\n", ramht->used, ramht->size);
 	return -ENOSPC;
 }
 
@@ -152,7 +207,7 @@ nvkm_ramht_new(struct nvkm_device *device, u32 size, u32 align,
 	ramht->size = size >> 3;
 	ramht->bits = order_base_2(ramht->size);
 	for (i = 0; i < ramht->size; i++)
-		ramht->data[i].chid = -1;
+		ramht->data[i].chid = NVKM_RAMHT_FREE;
 
 	ret = nvkm_gpuobj_new(ramht->device, size, align, true,
 			      ramht->parent, &ramht->gpuobj);
@@ -59,6 +59,7 @@ nvkm_subdev_fini(struct nvkm_subdev *subdev, bool suspend)
 
 	nvkm_trace(subdev, "%s running...\n", action);
 	time = ktime_to_us(ktime_get());
+	subdev->time.fini = 0;
 
 	if (subdev->func->fini) {
 		int ret = subdev->func->fini(subdev, suspend);
@@ -73,6 +74,7 @@ nvkm_subdev_fini(struct nvkm_subdev *subdev, bool suspend)
 	nvkm_mc_reset(device, subdev->type, subdev->inst);
 
 	time = ktime_to_us(ktime_get()) - time;
+	subdev->time.fini = time;
 	nvkm_trace(subdev, "%s completed in %lldus\n", action, time);
 	return 0;
 }
@@ -150,6 +152,7 @@ nvkm_subdev_init_(struct nvkm_subdev *subdev)
 	}
 
 	time = ktime_to_us(ktime_get()) - time;
+	subdev->time.init = time;
 	nvkm_trace(subdev, "init completed in %lldus\n", time);
 	return 0;
 }
@@ -160,6 +163,7 @@ nvkm_subdev_init(struct nvkm_subdev *subdev)
 	int ret;
 
 	mutex_lock(&subdev->use.mutex);
+	subdev->time.init = 0;
 	if (refcount_read(&subdev->use.refcount) == 0) {
 		nvkm_trace(subdev, "init skipped, no users\n");
 		mutex_unlock(&subdev->use.mutex);
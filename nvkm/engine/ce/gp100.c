@@ -88,6 +88,7 @@ gp100_ce_intr(struct nvkm_engine *ce)
 static const struct nvkm_engine_func
 gp100_ce = {
 	.intr = gp100_ce_intr,
+	.async = true,
 	.sclass = {
 		{ -1, -1, PASCAL_DMA_COPY_A },
 		{}
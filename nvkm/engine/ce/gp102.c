@@ -29,6 +29,7 @@
 static const struct nvkm_engine_func
 gp102_ce = {
 	.intr = gp100_ce_intr,
+	.async = true,
 	.sclass = {
 		{ -1, -1, PASCAL_DMA_COPY_B },
 		{ -1, -1, PASCAL_DMA_COPY_A },
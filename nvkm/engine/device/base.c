@@ -29,6 +29,10 @@
 #include <subdev/bios.h>
 #include <subdev/therm.h>
 
+#include <linux/async.h>
+
+static ASYNC_DOMAIN_EXCLUSIVE(nvkm_device_async);
+
 static DEFINE_MUTEX(nv_devices_mutex);
 static LIST_HEAD(nv_devices);
 
@@ -2846,11 +2850,105 @@ nvkm_device_engine(struct nvkm_device *device, int type, int inst)
 	return NULL;
 }
 
+static bool
+nvkm_device_subdev_async(struct nvkm_subdev *subdev)
+{
+	if (subdev->func == &nvkm_engine)
+		return container_of(subdev, struct nvkm_engine, subdev)->func->async;
+	return subdev->func->async;
+}
+
+static void
+nvkm_device_init_async(void *data, async_cookie_t cookie)
+{
+	struct nvkm_subdev *subdev = data;
+
+	subdev->async_ret = nvkm_subdev_init(subdev);
+}
+
+static void
+nvkm_device_fini_async(void *data, async_cookie_t cookie)
+{
+	struct nvkm_subdev *subdev = data;
+
+	subdev->async_ret = nvkm_subdev_fini(subdev, false);
+}
+
+static void
+nvkm_device_suspend_async(void *data, async_cookie_t cookie)
+{
+	struct nvkm_subdev *subdev = data;
+
+	subdev->async_ret = nvkm_subdev_fini(subdev, true);
+}
+
+/* Wait for a run of async subdevs, starting at 'batch' and walking in the
+ * direction they were scheduled, to complete.  On failure, the first error
+ * is returned and *plowest points at the earliest subdev of the run in list
+ * order, so callers can unwind the whole run.
+ */
+static int
+nvkm_device_async_wait(struct nvkm_device *device, struct nvkm_subdev *batch,
+		       bool reverse, struct nvkm_subdev **plowest)
+{
+	struct nvkm_subdev *subdev = batch;
+	int ret = 0;
+
+	async_synchronize_full_domain(&nvkm_device_async);
+
+	*plowest = batch;
+	if (!reverse) {
+		list_for_each_entry_from(subdev, &device->subdev, head) {
+			if (!nvkm_device_subdev_async(subdev))
+				break;
+			ret = ret ?: subdev->async_ret;
+		}
+	} else {
+		list_for_each_entry_from_reverse(subdev, &device->subdev, head) {
+			if (!nvkm_device_subdev_async(subdev))
+				break;
+			ret = ret ?: subdev->async_ret;
+			*plowest = subdev;
+		}
+	}
+
+	return ret;
+}
+
+/**
+ * nvkm_device_time_foreach - visit the init/fini timings of each subdev
+ * @device:	device to report on
+ * @func:	called with the name and most recent init/fini durations (in
+ *		us) of each subdev, zero if it was skipped
+ * @priv:	passed through to @func
+ *
+ * Iteration stops at the first non-zero return from @func, which is passed
+ * back to the caller.
+ */
+int
+nvkm_device_time_foreach(struct nvkm_device *device,
+			 int (*func)(void *priv, const char *name,
+				     s64 init, s64 fini),
+			 void *priv)
+{
+	struct nvkm_subdev *subdev;
+	int ret;
+
+	list_for_each_entry(subdev, &device->subdev, head) {
+		ret = func(priv, subdev->name, READ_ONCE(subdev->time.init),
+			   READ_ONCE(subdev->time.fini));
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
 int
 nvkm_device_fini(struct nvkm_device *device, bool suspend)
 {
 	const char *action = suspend ? "suspend" : "fini";
-	struct nvkm_subdev *subdev;
+	struct nvkm_subdev *subdev, *batch = NULL;
 	int ret;
 	s64 time;
 
@@ -2860,11 +2958,37 @@ nvkm_device_fini(struct nvkm_device *device, bool suspend)
 	nvkm_acpi_fini(device);
 
 	list_for_each_entry_reverse(subdev, &device->subdev, head) {
+		if (nvkm_device_subdev_async(subdev)) {
+			if (!batch)
+				batch = subdev;
+			async_schedule_domain(suspend ? nvkm_device_suspend_async :
+							nvkm_device_fini_async,
+					      subdev, &nvkm_device_async);
+			continue;
+		}
+
+		if (batch) {
+			ret = nvkm_device_async_wait(device, batch, true, &batch);
+			if (ret && suspend) {
+				subdev = batch;
+				goto fail;
+			}
+			batch = NULL;
+		}
+
 		ret = nvkm_subdev_fini(subdev, suspend);
 		if (ret && suspend)
 			goto fail;
 	}
 
+	if (batch) {
+		ret = nvkm_device_async_wait(device, batch, true, &batch);
+		if (ret && suspend) {
+			subdev = batch;
+			goto fail;
+		}
+	}
+
 	nvkm_therm_clkgate_fini(device->therm, suspend);
 
 	if (device->func->fini)
@@ -2935,7 +3059,7 @@ fail:
 int
 nvkm_device_init(struct nvkm_device *device)
 {
-	struct nvkm_subdev *subdev;
+	struct nvkm_subdev *subdev, *batch = NULL;
 	int ret;
 	s64 time;
 
@@ -2957,11 +3081,36 @@ nvkm_device_init(struct nvkm_device *device)
 	}
 
 	list_for_each_entry(subdev, &device->subdev, head) {
+		if (nvkm_device_subdev_async(subdev)) {
+			if (!batch)
+				batch = subdev;
+			async_schedule_domain(nvkm_device_init_async, subdev,
+					      &nvkm_device_async);
+			continue;
+		}
+
+		if (batch) {
+			ret = nvkm_device_async_wait(device, batch, false, &batch);
+			if (ret) {
+				subdev = batch;
+				goto fail_subdev;
+			}
+			batch = NULL;
+		}
+
 		ret = nvkm_subdev_init(subdev);
 		if (ret)
 			goto fail_subdev;
 	}
 
+	if (batch) {
+		ret = nvkm_device_async_wait(device, batch, false, &batch);
+		if (ret) {
+			subdev = batch;
+			goto fail_subdev;
+		}
+	}
+
 	nvkm_acpi_init(device);
 	nvkm_therm_clkgate_enable(device->therm);
 
@@ -2992,6 +3141,8 @@ nvkm_device_del(struct nvkm_device **pdevice)
 		list_for_each_entry_safe_reverse(subdev, subtmp, &device->subdev, head)
 			nvkm_subdev_del(&subdev);
 
+		nvkm_firmware_cache_fini(device);
+
 		if (device->pri)
 			iounmap(device->pri);
 		list_del(&device->head);
@@ -3064,6 +3215,10 @@ nvkm_device_ctor(const struct nvkm_device_func *func,
 	list_add_tail(&device->head, &nv_devices);
 	device->debug = nvkm_dbgopt(device->dbgopt, "device");
 	INIT_LIST_HEAD(&device->subdev);
+	mutex_init(&device->fw.mutex);
+	INIT_LIST_HEAD(&device->fw.list);
+	INIT_LIST_HEAD(&device->fw.log);
+	INIT_LIST_HEAD(&device->fw.images);
 
 	mmio_base = device->func->resource_addr(device, 0);
 	mmio_size = device->func->resource_size(device, 0);
@@ -3297,6 +3452,7 @@ nvkm_device_ctor(const struct nvkm_device_func *func,
 
 	mutex_init(&device->mutex);
 	nvkm_intr_ctor(device);
+	nvkm_firmware_prefetch(device);
 
 #define NVKM_LAYOUT_ONCE(type,data,ptr)                                                      \
 	if (device->chip->ptr.inst) {                                                        \
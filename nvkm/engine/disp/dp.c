@@ -309,6 +309,53 @@ nvkm_dp_train_cr(struct lt_state *lt)
 	return cr_done ? 0 : -1;
 }
 
+static void
+nvkm_dp_train_cache_put(struct lt_state *lt)
+{
+	struct nvkm_outp *outp = lt->outp;
+	struct nvkm_ior *ior = outp->ior;
+
+	memcpy(outp->dp.cache.dpcd, outp->dp.dpcd, sizeof(outp->dp.cache.dpcd));
+	memcpy(outp->dp.cache.conf, lt->conf, sizeof(outp->dp.cache.conf));
+	memcpy(outp->dp.cache.pc2conf, lt->pc2conf, sizeof(outp->dp.cache.pc2conf));
+	outp->dp.cache.lttprs = lt->repeaters;
+	outp->dp.cache.nr = ior->dp.nr;
+	outp->dp.cache.bw = ior->dp.bw;
+	outp->dp.cache.valid = true;
+}
+
+/* Seed the sink's adjust requests with the drive settings that trained the
+ * link last time, so clock recovery starts from (and usually completes at)
+ * the levels the sink settled on, rather than ramping up from zero.
+ */
+static bool
+nvkm_dp_train_cache_get(struct lt_state *lt)
+{
+	struct nvkm_outp *outp = lt->outp;
+	struct nvkm_ior *ior = outp->ior;
+	int i;
+
+	if (!outp->dp.cache.valid ||
+	    outp->dp.cache.lttprs != lt->repeaters ||
+	    outp->dp.cache.nr != ior->dp.nr ||
+	    outp->dp.cache.bw != ior->dp.bw ||
+	    memcmp(outp->dp.cache.dpcd, outp->dp.dpcd, sizeof(outp->dp.cache.dpcd)))
+		return false;
+
+	for (i = 0; i < ior->dp.nr; i++) {
+		u8 conf = outp->dp.cache.conf[i];
+		u8 lpc2 = (outp->dp.cache.pc2conf[i >> 1] >> ((i & 1) * 4)) & 0x3;
+		u8 lane = ((conf & DPCD_LC03_PRE_EMPHASIS_SET) >> 1) |
+			   (conf & DPCD_LC03_VOLTAGE_SWING_SET);
+
+		lt->stat[4 + (i >> 1)] |= lane << ((i & 1) * 4);
+		lt->pc2stat |= lpc2 << (i * 2);
+	}
+
+	OUTP_DBG(outp, "using cached drive settings %4ph", outp->dp.cache.conf);
+	return true;
+}
+
 static int
 nvkm_dp_train_link(struct nvkm_outp *outp, int rate)
 {
@@ -318,6 +365,7 @@ nvkm_dp_train_link(struct nvkm_outp *outp, int rate)
 		.pc2 = outp->dp.dpcd[DPCD_RC02] & DPCD_RC02_TPS3_SUPPORTED,
 		.repeaters = outp->dp.lttprs,
 	};
+	bool cached = false;
 	u8 sink[2];
 	int ret;
 
@@ -356,12 +404,34 @@ nvkm_dp_train_link(struct nvkm_outp *outp, int rate)
 			OUTP_DBG(outp, "training sink");
 
 		memset(lt.stat, 0x00, sizeof(lt.stat));
+		cached = !lt.repeater && nvkm_dp_train_cache_get(&lt);
+
 		ret = nvkm_dp_train_cr(&lt);
 		if (ret == 0)
 			ret = nvkm_dp_train_eq(&lt);
+
+		if (ret && cached) {
+			/* Sink no longer happy with the cached settings, start over. */
+			OUTP_DBG(outp, "cached drive settings failed, retraining");
+			outp->dp.cache.valid = false;
+
+			memset(lt.stat, 0x00, sizeof(lt.stat));
+			memset(lt.pc2conf, 0x00, sizeof(lt.pc2conf));
+			lt.pc2stat = 0x00;
+
+			ret = nvkm_dp_train_cr(&lt);
+			if (ret == 0)
+				ret = nvkm_dp_train_eq(&lt);
+		}
+
 		nvkm_dp_train_pattern(&lt, 0);
 	}
 
+	if (ret == 0)
+		nvkm_dp_train_cache_put(&lt);
+	else
+		outp->dp.cache.valid = false;
+
 	return ret;
 }
 
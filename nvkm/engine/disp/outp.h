@@ -60,6 +60,17 @@ struct nvkm_outp {
 				bool mst;
 				bool post_adj;
 			} lt;
+
+			/* Drive settings from the last successful training. */
+			struct {
+				bool valid;
+				u8 dpcd[DP_RECEIVER_CAP_SIZE];
+				u8 lttprs;
+				u8 nr;
+				u8 bw;
+				u8 conf[4];
+				u8 pc2conf[2];
+			} cache;
 		} dp;
 	};
 
@@ -1441,6 +1441,7 @@ gf100_grctx_generate(struct gf100_gr *gr, struct gf100_gr_chan *chan, struct nvk
 	struct nvkm_memory *data = NULL;
 	struct nvkm_vma *ctx = NULL;
 	int ret, i;
+	s64 time;
 	u64 addr;
 
 	/* NV_PGRAPH_FE_PWR_MODE_FORCE_ON. */
@@ -1512,7 +1513,10 @@ gf100_grctx_generate(struct gf100_gr *gr, struct gf100_gr_chan *chan, struct nvk
 		);
 	}
 
+	time = ktime_to_us(ktime_get());
 	grctx->main(chan);
+	time = ktime_to_us(ktime_get()) - time;
+	nvkm_debug(subdev, "grctx init packs written in %lldus\n", time);
 
 	if (!gr->firmware) {
 		/* Trigger a context unload by unsetting the "next channel valid" bit
@@ -1121,10 +1121,17 @@ gf100_gr_icmd(struct gf100_gr *gr, const struct gf100_gr_pack *p)
 			 */
 			if ((addr & 0xffff) == 0xe100)
 				gf100_gr_wait_idle(gr);
-			nvkm_msec(device, 2000,
-				if (!(nvkm_rd32(device, 0x400700) & 0x00000004))
-					break;
-			);
+
+			/* The ICMD has usually been consumed by the time we
+			 * get here, so check once before setting up a timed
+			 * wait, which costs extra PTIMER reads per bundle.
+			 */
+			if (nvkm_rd32(device, 0x400700) & 0x00000004) {
+				nvkm_msec(device, 2000,
+					if (!(nvkm_rd32(device, 0x400700) & 0x00000004))
+						break;
+				);
+			}
 			addr += init->pitch;
 		}
 	}
@@ -107,6 +107,36 @@ ga102_sec2_acr_bootstrap_falcon(struct nvkm_falcon *falcon, enum nvkm_acr_lsf_id
 				     msecs_to_jiffies(1000));
 }
 
+static int
+ga102_sec2_acr_bootstrap_multiple_falcons(struct nvkm_falcon *falcon, u32 mask)
+{
+	struct nvkm_sec2 *sec2 = container_of(falcon, typeof(*sec2), falcon);
+	struct nv_sec2_acr_bootstrap_falcon_cmd_v1 cmd[NVKM_ACR_LSF_NUM];
+	struct nvfw_falcon_cmd *hdr[NVKM_ACR_LSF_NUM];
+	unsigned long id, ids = mask;
+	int nr = 0;
+
+	for_each_set_bit(id, &ids, NVKM_ACR_LSF_NUM) {
+		cmd[nr] = (struct nv_sec2_acr_bootstrap_falcon_cmd_v1) {
+			.cmd.hdr.unit_id = sec2->func->unit_acr,
+			.cmd.hdr.size = sizeof(cmd[nr]),
+			.cmd.cmd_type = NV_SEC2_ACR_CMD_BOOTSTRAP_FALCON,
+			.flags = NV_SEC2_ACR_BOOTSTRAP_FALCON_FLAGS_RESET_YES,
+			.falcon_id = id,
+		};
+		hdr[nr] = &cmd[nr].cmd.hdr;
+		nr++;
+	}
+
+	if (!nr)
+		return 0;
+
+	return nvkm_falcon_cmdq_send_many(sec2->cmdq, hdr, nr,
+					  ga102_sec2_acr_bootstrap_falcon_callback,
+					  &sec2->engine.subdev,
+					  msecs_to_jiffies(1000));
+}
+
 static const struct nvkm_acr_lsf_func
 ga102_sec2_acr_0 = {
 	.bld_size = sizeof(struct flcn_bl_dmem_desc_v2),
@@ -116,6 +146,7 @@ ga102_sec2_acr_0 = {
 			     BIT_ULL(NVKM_ACR_LSF_GPCCS) |
 			     BIT_ULL(NVKM_ACR_LSF_SEC2),
 	.bootstrap_falcon = ga102_sec2_acr_bootstrap_falcon,
+	.bootstrap_multiple_falcons = ga102_sec2_acr_bootstrap_multiple_falcons,
 };
 
 static const struct nvkm_falcon_func
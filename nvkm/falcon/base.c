@@ -84,6 +84,14 @@ nvkm_falcon_dma_wr(struct nvkm_falcon *falcon, const u8 *img, u64 dma_addr, u32
 	src = dma_base;
 	if (len) {
 		while (len >= dmalen) {
+			if (dma->full) {
+				if (nvkm_msec(falcon->owner->device, 2000,
+					if (!dma->full(falcon))
+						break;
+				) < 0)
+					return -ETIMEDOUT;
+			}
+
 			dma->xfer(falcon, dst, src - dma_start, cmd);
 
 			if (img && nvkm_printk_ok(falcon->owner, falcon->user, NV_DBG_TRACE)) {
@@ -101,17 +109,27 @@ nvkm_falcon_dma_wr(struct nvkm_falcon *falcon, const u8 *img, u64 dma_addr, u32
 				}
 			}
 
-			if (nvkm_msec(falcon->owner->device, 2000,
-				if (dma->done(falcon))
-					break;
-			) < 0)
-				return -ETIMEDOUT;
+			if (!dma->full) {
+				if (nvkm_msec(falcon->owner->device, 2000,
+					if (dma->done(falcon))
+						break;
+				) < 0)
+					return -ETIMEDOUT;
+			}
 
 			src += dmalen;
 			dst += dmalen;
 			len -= dmalen;
 		}
 		WARN_ON(len);
+
+		if (dma->full) {
+			if (nvkm_msec(falcon->owner->device, 2000,
+				if (dma->done(falcon))
+					break;
+			) < 0)
+				return -ETIMEDOUT;
+		}
 	}
 
 	return 0;
@@ -96,21 +96,29 @@ nvkm_falcon_cmdq_close(struct nvkm_falcon_cmdq *cmdq)
 	mutex_unlock(&cmdq->mutex);
 }
 
+/* Commands are written contiguously, and the falcon is only notified
+ * (by the head pointer update) once all of them are in the queue.
+ */
 static int
-nvkm_falcon_cmdq_write(struct nvkm_falcon_cmdq *cmdq, struct nvfw_falcon_cmd *cmd)
+nvkm_falcon_cmdq_write(struct nvkm_falcon_cmdq *cmdq, struct nvfw_falcon_cmd **cmd, int nr)
 {
 	static unsigned timeout = 2000;
 	unsigned long end_jiffies = jiffies + msecs_to_jiffies(timeout);
-	int ret = -EAGAIN;
+	u32 size = 0;
+	int ret = -EAGAIN, i;
+
+	for (i = 0; i < nr; i++)
+		size += ALIGN(cmd[i]->size, QUEUE_ALIGNMENT);
 
 	while (ret == -EAGAIN && time_before(jiffies, end_jiffies))
-		ret = nvkm_falcon_cmdq_open(cmdq, cmd->size);
+		ret = nvkm_falcon_cmdq_open(cmdq, size);
 	if (ret) {
 		FLCNQ_ERR(cmdq, "timeout waiting for queue space");
 		return ret;
 	}
 
-	nvkm_falcon_cmdq_push(cmdq, cmd, cmd->size);
+	for (i = 0; i < nr; i++)
+		nvkm_falcon_cmdq_push(cmdq, cmd[i], cmd[i]->size);
 	nvkm_falcon_cmdq_close(cmdq);
 	return ret;
 }
@@ -120,13 +128,27 @@ nvkm_falcon_cmdq_write(struct nvkm_falcon_cmdq *cmdq, struct nvfw_falcon_cmd *cm
 /* specifies that we want an interrupt when the answer message is queued */
 #define CMD_FLAGS_INTR BIT(1)
 
+/**
+ * nvkm_falcon_cmdq_send_many - submit several commands with one notification
+ * @cmdq:	queue to submit to
+ * @cmd:	array of commands
+ * @nr:	number of commands in @cmd
+ * @cb:	called from message processing with each command's reply
+ * @priv:	passed to @cb
+ * @timeout:	jiffies to wait for each reply, or 0 to return without waiting
+ *
+ * When @timeout is 0, the sequences are released from the message handler
+ * once @cb has run.  Otherwise, the first non-zero @cb result is returned.
+ */
 int
-nvkm_falcon_cmdq_send(struct nvkm_falcon_cmdq *cmdq, struct nvfw_falcon_cmd *cmd,
-		      nvkm_falcon_qmgr_callback cb, void *priv,
-		      unsigned long timeout)
+nvkm_falcon_cmdq_send_many(struct nvkm_falcon_cmdq *cmdq, struct nvfw_falcon_cmd **cmd, int nr,
+			   nvkm_falcon_qmgr_callback cb, void *priv, unsigned long timeout)
 {
-	struct nvkm_falcon_qmgr_seq *seq;
-	int ret;
+	struct nvkm_falcon_qmgr_seq *seq[8];
+	int ret = 0, i;
+
+	if (WARN_ON(nr < 1 || nr > ARRAY_SIZE(seq)))
+		return -EINVAL;
 
 	if (!wait_for_completion_timeout(&cmdq->ready,
 					 msecs_to_jiffies(1000))) {
@@ -134,37 +156,66 @@ nvkm_falcon_cmdq_send(struct nvkm_falcon_cmdq *cmdq, struct nvfw_falcon_cmd *cmd
 		return -ETIMEDOUT;
 	}
 
-	seq = nvkm_falcon_qmgr_seq_acquire(cmdq->qmgr);
-	if (IS_ERR(seq))
-		return PTR_ERR(seq);
+	for (i = 0; i < nr; i++) {
+		seq[i] = nvkm_falcon_qmgr_seq_acquire(cmdq->qmgr);
+		if (IS_ERR(seq[i])) {
+			ret = PTR_ERR(seq[i]);
+			while (i--)
+				nvkm_falcon_qmgr_seq_release(cmdq->qmgr, seq[i]);
+			return ret;
+		}
 
-	cmd->seq_id = seq->id;
-	cmd->ctrl_flags = CMD_FLAGS_STATUS | CMD_FLAGS_INTR;
+		cmd[i]->seq_id = seq[i]->id;
+		cmd[i]->ctrl_flags = CMD_FLAGS_STATUS | CMD_FLAGS_INTR;
 
-	seq->state = SEQ_STATE_USED;
-	seq->async = !timeout;
-	seq->callback = cb;
-	seq->priv = priv;
+		seq[i]->state = SEQ_STATE_USED;
+		seq[i]->async = !timeout;
+		seq[i]->callback = cb;
+		seq[i]->priv = priv;
+	}
 
-	ret = nvkm_falcon_cmdq_write(cmdq, cmd);
+	ret = nvkm_falcon_cmdq_write(cmdq, cmd, nr);
 	if (ret) {
-		seq->state = SEQ_STATE_PENDING;
-		nvkm_falcon_qmgr_seq_release(cmdq->qmgr, seq);
+		for (i = 0; i < nr; i++) {
+			seq[i]->state = SEQ_STATE_PENDING;
+			nvkm_falcon_qmgr_seq_release(cmdq->qmgr, seq[i]);
+		}
 		return ret;
 	}
 
-	if (!seq->async) {
-		if (!wait_for_completion_timeout(&seq->done, timeout)) {
+	if (!timeout)
+		return 0;
+
+	for (i = 0; i < nr; i++) {
+		if (!wait_for_completion_timeout(&seq[i]->done, timeout)) {
 			FLCNQ_ERR(cmdq, "timeout waiting for reply");
+
+			/* Hand the outstanding sequences over to the message
+			 * handler, which will release them if a reply turns
+			 * up, unless one already has.
+			 */
+			for (; i < nr; i++) {
+				seq[i]->state = SEQ_STATE_CANCELLED;
+				if (xchg(&seq[i]->async, true))
+					nvkm_falcon_qmgr_seq_release(cmdq->qmgr, seq[i]);
+			}
 			return -ETIMEDOUT;
 		}
-		ret = seq->result;
-		nvkm_falcon_qmgr_seq_release(cmdq->qmgr, seq);
+		ret = ret ?: seq[i]->result;
+		nvkm_falcon_qmgr_seq_release(cmdq->qmgr, seq[i]);
 	}
 
 	return ret;
 }
 
+int
+nvkm_falcon_cmdq_send(struct nvkm_falcon_cmdq *cmdq, struct nvfw_falcon_cmd *cmd,
+		      nvkm_falcon_qmgr_callback cb, void *priv,
+		      unsigned long timeout)
+{
+	return nvkm_falcon_cmdq_send_many(cmdq, &cmd, 1, cb, priv, timeout);
+}
+
 void
 nvkm_falcon_cmdq_fini(struct nvkm_falcon_cmdq *cmdq)
 {
@@ -75,6 +75,7 @@ nvkm_falcon_fw_boot(struct nvkm_falcon_fw *fw, struct nvkm_subdev *user,
 		    bool release, u32 *pmbox0, u32 *pmbox1, u32 mbox0_ok, u32 irqsclr)
 {
 	struct nvkm_falcon *falcon = fw->falcon;
+	s64 time;
 	int ret;
 
 	ret = nvkm_falcon_get(falcon, user);
@@ -106,10 +107,14 @@ nvkm_falcon_fw_boot(struct nvkm_falcon_fw *fw, struct nvkm_subdev *user,
 				   sg_dma_len(&fw->fw.mem.sgl),
 				   DMA_TO_DEVICE);
 
+	time = ktime_to_us(ktime_get());
 	ret = fw->func->load(fw);
 	if (ret)
 		goto done;
 
+	time = ktime_to_us(ktime_get()) - time;
+	FLCNFW_DBG(fw, "loaded %d bytes in %lldus", fw->fw.len, time);
+
 	FLCNFW_DBG(fw, "booting");
 	ret = fw->func->boot(fw, pmbox0, pmbox1, mbox0_ok, irqsclr);
 	if (ret)
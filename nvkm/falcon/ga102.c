@@ -36,6 +36,12 @@ ga102_flcn_dma_done(struct nvkm_falcon *falcon)
 	return !!(nvkm_falcon_rd32(falcon, 0x118) & 0x00000002);
 }
 
+static bool
+ga102_flcn_dma_full(struct nvkm_falcon *falcon)
+{
+	return !!(nvkm_falcon_rd32(falcon, 0x118) & 0x00000001);
+}
+
 static void
 ga102_flcn_dma_xfer(struct nvkm_falcon *falcon, u32 mem_base, u32 dma_base, u32 cmd)
 {
@@ -64,6 +70,7 @@ ga102_flcn_dma = {
 	.init = ga102_flcn_dma_init,
 	.xfer = ga102_flcn_dma_xfer,
 	.done = ga102_flcn_dma_done,
+	.full = ga102_flcn_dma_full,
 };
 
 int
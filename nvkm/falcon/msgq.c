@@ -127,7 +127,10 @@ nvkm_falcon_msgq_exec(struct nvkm_falcon_msgq *msgq, struct nvfw_falcon_msg *hdr
 			seq->result = seq->callback(seq->priv, hdr);
 	}
 
-	if (seq->async) {
+	/* The sender may give up waiting at any time, so whichever of us
+	 * sets async second releases the sequence.
+	 */
+	if (xchg(&seq->async, true)) {
 		nvkm_falcon_qmgr_seq_release(msgq->qmgr, seq);
 		return 0;
 	}
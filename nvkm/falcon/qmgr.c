@@ -29,16 +29,13 @@ nvkm_falcon_qmgr_seq_acquire(struct nvkm_falcon_qmgr *qmgr)
 	struct nvkm_falcon_qmgr_seq *seq;
 	u32 index;
 
-	mutex_lock(&qmgr->seq.mutex);
-	index = find_first_zero_bit(qmgr->seq.tbl, NVKM_FALCON_QMGR_SEQ_NUM);
-	if (index >= NVKM_FALCON_QMGR_SEQ_NUM) {
-		nvkm_error(subdev, "no free sequence available\n");
-		mutex_unlock(&qmgr->seq.mutex);
-		return ERR_PTR(-EAGAIN);
-	}
-
-	set_bit(index, qmgr->seq.tbl);
-	mutex_unlock(&qmgr->seq.mutex);
+	do {
+		index = find_first_zero_bit(qmgr->seq.tbl, NVKM_FALCON_QMGR_SEQ_NUM);
+		if (index >= NVKM_FALCON_QMGR_SEQ_NUM) {
+			nvkm_error(subdev, "no free sequence available\n");
+			return ERR_PTR(-EAGAIN);
+		}
+	} while (test_and_set_bit(index, qmgr->seq.tbl));
 
 	seq = &qmgr->seq.id[index];
 	seq->state = SEQ_STATE_PENDING;
@@ -49,7 +46,6 @@ void
 nvkm_falcon_qmgr_seq_release(struct nvkm_falcon_qmgr *qmgr,
 			     struct nvkm_falcon_qmgr_seq *seq)
 {
-	/* no need to acquire seq.mutex since clear_bit is atomic */
 	seq->state = SEQ_STATE_FREE;
 	seq->callback = NULL;
 	reinit_completion(&seq->done);
@@ -77,7 +73,6 @@ nvkm_falcon_qmgr_new(struct nvkm_falcon *falcon,
 		return -ENOMEM;
 
 	qmgr->falcon = falcon;
-	mutex_init(&qmgr->seq.mutex);
 	for (i = 0; i < NVKM_FALCON_QMGR_SEQ_NUM; i++) {
 		qmgr->seq.id[i].id = i;
 		init_completion(&qmgr->seq.id[i].done);
@@ -17,6 +17,8 @@
  *
  * @id:		sequence ID
  * @state:	current state
+ * @async:	nobody is waiting on the reply, or it has already arrived;
+ *		whoever finds it already set releases the sequence
  * @callback:	callback to call upon receiving matching message
  * @completion:	completion to signal after callback is called
  */
@@ -45,7 +47,6 @@ struct nvkm_falcon_qmgr {
 	struct nvkm_falcon *falcon;
 
 	struct {
-		struct mutex mutex;
 		struct nvkm_falcon_qmgr_seq id[NVKM_FALCON_QMGR_SEQ_NUM];
 		unsigned long tbl[BITS_TO_LONGS(NVKM_FALCON_QMGR_SEQ_NUM)];
 	} seq;
@@ -24,9 +24,12 @@
 #include "priv.h"
 
 #include <core/option.h>
+#include <core/pci.h>
 #include <subdev/bios.h>
 #include <subdev/bios/image.h>
 
+#include <linux/crc32.h>
+
 struct shadow {
 	u32 skip;
 	const struct nvbios_source *func;
@@ -132,6 +135,132 @@ shadow_method(struct nvkm_bios *bios, struct shadow *mthd, const char *name)
 	return mthd->score;
 }
 
+/* The source an image was shadowed from is remembered for each PCI device,
+ * along with the image's size and checksum, so rebinding the driver only has
+ * to read the image from that source instead of probing every source again.
+ * The image is only used if it still matches, in case the ROM has been
+ * reflashed (or the board swapped) in the meantime.
+ */
+struct shadow_cache {
+	struct list_head head;
+	const struct nvbios_source *func;
+	char name[32];
+	u16 vendor;
+	u16 device;
+	u16 subsystem_vendor;
+	u16 subsystem_device;
+	u32 crc;
+	u32 size;
+};
+
+static LIST_HEAD(shadow_cache_list);
+static DEFINE_MUTEX(shadow_cache_mutex);
+
+static struct pci_dev *
+shadow_cache_pdev(struct nvkm_bios *bios)
+{
+	struct nvkm_device *device = bios->subdev.device;
+
+	if (!device->func->pci)
+		return NULL;
+	return device->func->pci(device)->pdev;
+}
+
+static bool
+shadow_cache_match(struct shadow_cache *cache, struct pci_dev *pdev)
+{
+	return !strcmp(cache->name, pci_name(pdev)) &&
+	       cache->vendor == pdev->vendor &&
+	       cache->device == pdev->device &&
+	       cache->subsystem_vendor == pdev->subsystem_vendor &&
+	       cache->subsystem_device == pdev->subsystem_device;
+}
+
+static bool
+shadow_cache_get(struct nvkm_bios *bios)
+{
+	struct nvkm_subdev *subdev = &bios->subdev;
+	struct pci_dev *pdev = shadow_cache_pdev(bios);
+	struct shadow_cache *cache;
+	struct shadow mthd = {};
+	bool found = false;
+
+	if (!pdev)
+		return false;
+
+	mutex_lock(&shadow_cache_mutex);
+	list_for_each_entry(cache, &shadow_cache_list, head) {
+		if (!shadow_cache_match(cache, pdev))
+			continue;
+
+		mthd.func = cache->func;
+		if (shadow_method(bios, &mthd, NULL) &&
+		    mthd.size == cache->size &&
+		    crc32_le(~0, mthd.data, mthd.size) == cache->crc) {
+			bios->data = mthd.data;
+			bios->size = mthd.size;
+			found = true;
+			break;
+		}
+
+		nvkm_debug(subdev, "image from %s changed, probing all sources\n",
+			   cache->func->name);
+		kfree(mthd.data);
+		list_del(&cache->head);
+		kfree(cache);
+		break;
+	}
+	mutex_unlock(&shadow_cache_mutex);
+	return found;
+}
+
+static void
+shadow_cache_put(struct nvkm_bios *bios, const struct nvbios_source *func)
+{
+	struct pci_dev *pdev = shadow_cache_pdev(bios);
+	struct shadow_cache *cache, *temp;
+
+	if (!pdev)
+		return;
+
+	cache = kmalloc(sizeof(*cache), GFP_KERNEL);
+	if (!cache)
+		return;
+
+	cache->func = func;
+	strscpy(cache->name, pci_name(pdev), sizeof(cache->name));
+	cache->vendor = pdev->vendor;
+	cache->device = pdev->device;
+	cache->subsystem_vendor = pdev->subsystem_vendor;
+	cache->subsystem_device = pdev->subsystem_device;
+	cache->size = bios->size;
+	cache->crc = crc32_le(~0, bios->data, bios->size);
+
+	mutex_lock(&shadow_cache_mutex);
+	list_for_each_entry(temp, &shadow_cache_list, head) {
+		if (shadow_cache_match(temp, pdev)) {
+			list_del(&temp->head);
+			kfree(temp);
+			break;
+		}
+	}
+	list_add_tail(&cache->head, &shadow_cache_list);
+	mutex_unlock(&shadow_cache_mutex);
+}
+
+void
+nvkm_bios_cache_fini(void)
+{
+	struct shadow_cache *cache, *temp;
+
+	mutex_lock(&shadow_cache_mutex);
+	list_for_each_entry_safe(cache, temp, &shadow_cache_list, head) {
+		list_del(&cache->head);
+		kfree(cache);
+	}
+	mutex_unlock(&shadow_cache_mutex);
+}
+
 static u32
 shadow_fw_read(void *data, u32 offset, u32 length, struct nvkm_bios *bios)
 {
@@ -216,6 +345,14 @@ nvbios_shadow(struct nvkm_bios *bios)
 		}
 	}
 
+	/* use the source from a previous probe of this device, if it still
+	 * provides the same image
+	 */
+	if (!source && shadow_cache_get(bios)) {
+		nvkm_debug(subdev, "using image from cached source\n");
+		return 0;
+	}
+
 	/* scan all potential bios sources, looking for best image */
 	if (!best || !best->score) {
 		for (mthd = mthds, best = mthd; mthd->func; mthd++) {
@@ -243,6 +380,8 @@ nvbios_shadow(struct nvkm_bios *bios)
 		   best->func->name : source);
 	bios->data = best->data;
 	bios->size = best->size;
+	if (!source)
+		shadow_cache_put(bios, best->func);
 	kfree(source);
 	return 0;
 }
@@ -27,6 +27,54 @@
 
 #include <nvif/class.h>
 
+static void
+gv100_fault_buffer_entry(struct nvkm_fault_buffer *buffer, u32 get,
+			 struct nvkm_fault_data *info)
+{
+	struct nvkm_memory *mem = buffer->mem;
+	const u32   base = get * buffer->fault->func->buffer.entry_size;
+	const u32 instlo = nvkm_ro32(mem, base + 0x00);
+	const u32 insthi = nvkm_ro32(mem, base + 0x04);
+	const u32 addrlo = nvkm_ro32(mem, base + 0x08);
+	const u32 addrhi = nvkm_ro32(mem, base + 0x0c);
+	const u32 timelo = nvkm_ro32(mem, base + 0x10);
+	const u32 timehi = nvkm_ro32(mem, base + 0x14);
+	const u32  info0 = nvkm_ro32(mem, base + 0x18);
+	const u32  info1 = nvkm_ro32(mem, base + 0x1c);
+
+	info->addr   = ((u64)addrhi << 32) | addrlo;
+	info->inst   = ((u64)insthi << 32) | instlo;
+	info->time   = ((u64)timehi << 32) | timelo;
+	info->engine = (info0 & 0x000000ff);
+	info->valid  = (info1 & 0x80000000) >> 31;
+	info->gpc    = (info1 & 0x1f000000) >> 24;
+	info->hub    = (info1 & 0x00100000) >> 20;
+	info->access = (info1 & 0x000f0000) >> 16;
+	info->client = (info1 & 0x00007f00) >> 8;
+	info->reason = (info1 & 0x0000001f);
+}
+
+/* A misbehaving channel tends to fault repeatedly on the same address, in
+ * which case there's nothing to gain from reporting (and attempting to
+ * recover from) each of them individually.
+ */
+static bool
+gv100_fault_buffer_dup(const struct nvkm_fault_data *info,
+		       const struct nvkm_fault_data *batch, int nr)
+{
+	int i;
+
+	for (i = 0; i < nr; i++) {
+		if (batch[i].inst   == info->inst &&
+		    batch[i].addr   == info->addr &&
+		    batch[i].access == info->access &&
+		    batch[i].reason == info->reason)
+			return true;
+	}
+
+	return false;
+}
+
 void
 gv100_fault_buffer_process(struct work_struct *work)
 {
@@ -34,42 +82,36 @@ gv100_fault_buffer_process(struct work_struct *work)
 	struct nvkm_fault_buffer *buffer = fault->buffer[0];
 	struct nvkm_device *device = fault->subdev.device;
 	struct nvkm_memory *mem = buffer->mem;
+	struct nvkm_fault_data batch[16];
 	u32 get = nvkm_rd32(device, buffer->get);
 	u32 put = nvkm_rd32(device, buffer->put);
-	if (put == get)
-		return;
+	int nr, dup, i;
 
-	nvkm_kmap(mem);
 	while (get != put) {
-		const u32   base = get * buffer->fault->func->buffer.entry_size;
-		const u32 instlo = nvkm_ro32(mem, base + 0x00);
-		const u32 insthi = nvkm_ro32(mem, base + 0x04);
-		const u32 addrlo = nvkm_ro32(mem, base + 0x08);
-		const u32 addrhi = nvkm_ro32(mem, base + 0x0c);
-		const u32 timelo = nvkm_ro32(mem, base + 0x10);
-		const u32 timehi = nvkm_ro32(mem, base + 0x14);
-		const u32  info0 = nvkm_ro32(mem, base + 0x18);
-		const u32  info1 = nvkm_ro32(mem, base + 0x1c);
-		struct nvkm_fault_data info;
-
-		if (++get == buffer->entries)
-			get = 0;
+		/* Snapshot a batch of entries, and release them back to HW
+		 * with a single GET update before notifying FIFO.
+		 */
+		nvkm_kmap(mem);
+		for (nr = dup = 0; get != put && nr < ARRAY_SIZE(batch); ) {
+			gv100_fault_buffer_entry(buffer, get, &batch[nr]);
+			if (++get == buffer->entries)
+				get = 0;
+
+			if (gv100_fault_buffer_dup(&batch[nr], batch, nr))
+				dup++;
+			else
+				nr++;
+		}
+		nvkm_done(mem);
+
 		nvkm_wr32(device, buffer->get, get);
 
-		info.addr   = ((u64)addrhi << 32) | addrlo;
-		info.inst   = ((u64)insthi << 32) | instlo;
-		info.time   = ((u64)timehi << 32) | timelo;
-		info.engine = (info0 & 0x000000ff);
-		info.valid  = (info1 & 0x80000000) >> 31;
-		info.gpc    = (info1 & 0x1f000000) >> 24;
-		info.hub    = (info1 & 0x00100000) >> 20;
-		info.access = (info1 & 0x000f0000) >> 16;
-		info.client = (info1 & 0x00007f00) >> 8;
-		info.reason = (info1 & 0x0000001f);
-
-		nvkm_fifo_fault(device->fifo, &info);
+		if (dup)
+			nvkm_debug(&fault->subdev, "%d duplicate fault(s) dropped\n", dup);
+
+		for (i = 0; i < nr; i++)
+			nvkm_fifo_fault(device->fifo, &batch[i]);
 	}
-	nvkm_done(mem);
 }
 
 static void
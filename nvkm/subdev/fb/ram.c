@@ -33,8 +33,361 @@ struct nvkm_vram {
 	struct nvkm_ram *ram;
 	u8 page;
 	struct nvkm_mm_node *mn;
+	struct nvkm_ram_slab *slab;
+};
+
+/* Small allocations are sub-allocated from per-CPU slabs, so that they don't
+ * need to take ram->mutex, or walk the (potentially very long) VRAM free list.
+ *
+ * Each CPU has a current slab per heap and page size, which allocations are
+ * carved from until it's full, at which point it's replaced.  A replaced slab
+ * that's still partially used goes onto ram->slab.list, where it can become
+ * some CPU's current slab again, and is returned to the VRAM allocator once
+ * all its allocations have been freed.
+ *
+ * If VRAM runs out, slabs on the list are split up into their individual
+ * allocations, and the free space between them given back.
+ */
+#define NVKM_RAM_SLAB_SHIFT 21
+#define NVKM_RAM_SLAB_UNITS BIT(NVKM_RAM_SLAB_SHIFT - NVKM_RAM_MM_SHIFT)
+#define NVKM_RAM_SLAB_MAX   SZ_256K
+
+static const u8
+nvkm_ram_slab_heap[] = { NVKM_RAM_MM_NORMAL, NVKM_RAM_MM_MIXED };
+static const u8
+nvkm_ram_slab_page[] = { 12, 16, 17 };
+
+#define NVKM_RAM_SLAB_NR \
+	(ARRAY_SIZE(nvkm_ram_slab_heap) * ARRAY_SIZE(nvkm_ram_slab_page))
+
+struct nvkm_ram_slab {
+	struct list_head head;
+	struct nvkm_mm_node *mn; /* Chain of allocated pieces once split. */
+	spinlock_t lock;
+	int idx;
+	u32 base;
+	bool active; /* Current slab of a CPU. */
+	bool dying;  /* Empty, being returned to the VRAM allocator. */
+	bool split;
+	u32 used;
+	DECLARE_BITMAP(map, NVKM_RAM_SLAB_UNITS);
+	DECLARE_BITMAP(first, NVKM_RAM_SLAB_UNITS);
+};
+
+struct nvkm_ram_slab_pcp {
+	spinlock_t lock;
+	struct nvkm_ram_slab *slab[NVKM_RAM_SLAB_NR];
 };
 
+static int
+nvkm_ram_slab_index(u8 heap, u8 type, u8 page)
+{
+	int h, p;
+
+	if (type != 0x01)
+		return -1;
+
+	for (h = 0; h < ARRAY_SIZE(nvkm_ram_slab_heap); h++) {
+		if (nvkm_ram_slab_heap[h] != heap)
+			continue;
+
+		for (p = 0; p < ARRAY_SIZE(nvkm_ram_slab_page); p++) {
+			if (nvkm_ram_slab_page[p] == page)
+				return h * ARRAY_SIZE(nvkm_ram_slab_page) + p;
+		}
+	}
+
+	return -1;
+}
+
+/* Must be called with ram->mutex held. */
+static void
+nvkm_ram_slab_del(struct nvkm_ram *ram, struct nvkm_ram_slab *slab)
+{
+	list_del(&slab->head);
+	nvkm_mm_free(&ram->vram, &slab->mn);
+	kfree(slab);
+}
+
+/* Must be called with ram->mutex held. */
+static struct nvkm_ram_slab *
+nvkm_ram_slab_new(struct nvkm_ram *ram, int idx, u8 heap, u8 type)
+{
+	const u32 units = NVKM_RAM_SLAB_UNITS;
+	struct nvkm_ram_slab *slab;
+	int ret;
+
+	if (!(slab = kzalloc(sizeof(*slab), GFP_KERNEL)))
+		return NULL;
+
+	INIT_LIST_HEAD(&slab->head);
+	spin_lock_init(&slab->lock);
+	slab->idx = idx;
+	slab->active = true;
+
+	ret = nvkm_mm_head(&ram->vram, heap, type, units, units, units,
+			   &slab->mn);
+	if (ret) {
+		kfree(slab);
+		return NULL;
+	}
+
+	slab->mn->next = NULL;
+	slab->base = slab->mn->offset;
+	return slab;
+}
+
+/* Split a slab into a chain of its allocations, and give the free space
+ * between them back to the VRAM allocator.  Must be called with ram->mutex
+ * held, on a slab that isn't the current slab of any CPU.
+ */
+static void
+nvkm_ram_slab_split(struct nvkm_ram *ram, struct nvkm_ram_slab *slab)
+{
+	struct nvkm_mm_node *rest, *node, **tail;
+	u32 i, j;
+
+	spin_lock(&slab->lock);
+	if (slab->dying) {
+		spin_unlock(&slab->lock);
+		return;
+	}
+
+	/* From here on, the slab is only touched with ram->mutex held. */
+	slab->split = true;
+	spin_unlock(&slab->lock);
+
+	list_del_init(&slab->head);
+
+	rest = slab->mn;
+	tail = &slab->mn;
+	for (i = 0; i < NVKM_RAM_SLAB_UNITS && rest; i = j) {
+		bool used = test_bit(i, slab->map);
+
+		if (used) {
+			j = min(find_next_bit(slab->first, NVKM_RAM_SLAB_UNITS, i + 1),
+				find_next_zero_bit(slab->map, NVKM_RAM_SLAB_UNITS, i));
+		} else {
+			j = find_next_bit(slab->map, NVKM_RAM_SLAB_UNITS, i);
+		}
+
+		node = nvkm_mm_split(&ram->vram, rest, j - i);
+		if (!node)
+			break;
+		if (node == rest)
+			rest = NULL;
+
+		if (used) {
+			*tail = node;
+			tail = &node->next;
+		} else {
+			nvkm_mm_free(&ram->vram, &node);
+		}
+	}
+
+	/* Whatever couldn't be split stays allocated as a single piece. */
+	*tail = rest;
+	if (rest)
+		rest->next = NULL;
+}
+
+/* Must be called with slab->lock held. */
+static bool
+nvkm_ram_slab_alloc(struct nvkm_ram_slab *slab, u32 size, u32 align,
+		    struct nvkm_mm_node *mn)
+{
+	unsigned long i;
+
+	i = bitmap_find_next_zero_area(slab->map, NVKM_RAM_SLAB_UNITS, 0,
+				       size, align - 1);
+	if (i >= NVKM_RAM_SLAB_UNITS)
+		return false;
+
+	bitmap_set(slab->map, i, size);
+	set_bit(i, slab->first);
+	slab->used += size;
+
+	mn->offset = slab->base + i;
+	mn->length = size;
+	mn->heap = slab->mn->heap;
+	mn->type = slab->mn->type;
+	return true;
+}
+
+/* Stop allocating from a CPU's current slab, freeing it if it's unused. */
+static void
+nvkm_ram_slab_retire(struct nvkm_ram *ram, struct nvkm_ram_slab *slab)
+{
+	bool unused;
+
+	mutex_lock(&ram->mutex);
+	spin_lock(&slab->lock);
+	slab->active = false;
+	unused = !slab->used;
+	if (unused)
+		slab->dying = true;
+	spin_unlock(&slab->lock);
+
+	if (unused)
+		nvkm_ram_slab_del(ram, slab);
+	else
+		list_add_tail(&slab->head, &ram->slab.list);
+	mutex_unlock(&ram->mutex);
+}
+
+static void
+nvkm_ram_slab_put(struct nvkm_ram *ram, struct nvkm_ram_slab *slab,
+		  struct nvkm_mm_node *mn)
+{
+	const u32 i = mn->offset - slab->base;
+	struct nvkm_mm_node *node, **pnode;
+	bool unused;
+
+	spin_lock(&slab->lock);
+	if (!slab->split) {
+		bitmap_clear(slab->map, i, mn->length);
+		clear_bit(i, slab->first);
+		slab->used -= mn->length;
+		unused = !slab->used && !slab->active;
+		if (unused)
+			slab->dying = true;
+		spin_unlock(&slab->lock);
+
+		if (unused) {
+			mutex_lock(&ram->mutex);
+			nvkm_ram_slab_del(ram, slab);
+			mutex_unlock(&ram->mutex);
+		}
+		return;
+	}
+	spin_unlock(&slab->lock);
+
+	/* Slab has been split, free the piece covering this allocation once
+	 * nothing else in it is still allocated.
+	 */
+	mutex_lock(&ram->mutex);
+	bitmap_clear(slab->map, i, mn->length);
+	clear_bit(i, slab->first);
+	slab->used -= mn->length;
+
+	for (pnode = &slab->mn; (node = *pnode); pnode = &node->next) {
+		const u32 s = node->offset - slab->base;
+		const u32 e = s + node->length;
+
+		if (i < s || i >= e)
+			continue;
+
+		if (find_next_bit(slab->map, e, s) >= e) {
+			*pnode = node->next;
+			nvkm_mm_free(&ram->vram, &node);
+		}
+		break;
+	}
+
+	unused = !slab->used;
+	mutex_unlock(&ram->mutex);
+
+	if (unused) {
+		WARN_ON(slab->mn);
+		kfree(slab);
+	}
+}
+
+static struct nvkm_ram_slab *
+nvkm_ram_slab_get(struct nvkm_ram *ram, int idx, u8 heap, u8 type,
+		  u32 size, u32 align, struct nvkm_mm_node *mn)
+{
+	struct nvkm_ram_slab_pcp *pcp;
+	struct nvkm_ram_slab *slab, *old;
+	bool found = false;
+
+	/* Try the current slab of whichever CPU we happen to be on.  Being
+	 * migrated to another CPU in the meantime is harmless.
+	 */
+	pcp = raw_cpu_ptr(ram->slab.pcp);
+	spin_lock(&pcp->lock);
+	slab = pcp->slab[idx];
+	if (slab) {
+		spin_lock(&slab->lock);
+		found = nvkm_ram_slab_alloc(slab, size, align, mn);
+		spin_unlock(&slab->lock);
+	}
+	spin_unlock(&pcp->lock);
+	if (found)
+		return slab;
+
+	/* Current slab is full (or there isn't one), replace it with one that
+	 * was partially freed if possible, or a new one otherwise.
+	 */
+	mutex_lock(&ram->mutex);
+	list_for_each_entry(slab, &ram->slab.list, head) {
+		if (slab->idx != idx)
+			continue;
+
+		spin_lock(&slab->lock);
+		if (!slab->dying && nvkm_ram_slab_alloc(slab, size, align, mn)) {
+			slab->active = true;
+			found = true;
+		}
+		spin_unlock(&slab->lock);
+
+		if (found) {
+			list_del_init(&slab->head);
+			break;
+		}
+	}
+
+	if (!found) {
+		slab = nvkm_ram_slab_new(ram, idx, heap, type);
+		if (slab) {
+			spin_lock(&slab->lock);
+			WARN_ON(!nvkm_ram_slab_alloc(slab, size, align, mn));
+			spin_unlock(&slab->lock);
+		}
+	}
+	mutex_unlock(&ram->mutex);
+
+	if (!slab)
+		return NULL;
+
+	spin_lock(&pcp->lock);
+	old = pcp->slab[idx];
+	pcp->slab[idx] = slab;
+	spin_unlock(&pcp->lock);
+
+	if (old)
+		nvkm_ram_slab_retire(ram, old);
+
+	return slab;
+}
+
+/* Return all free space held by slabs to the VRAM allocator. */
+static void
+nvkm_ram_slab_flush(struct nvkm_ram *ram)
+{
+	struct nvkm_ram_slab_pcp *pcp;
+	struct nvkm_ram_slab *slab, *temp;
+	int cpu, i;
+
+	for_each_possible_cpu(cpu) {
+		pcp = per_cpu_ptr(ram->slab.pcp, cpu);
+		for (i = 0; i < NVKM_RAM_SLAB_NR; i++) {
+			spin_lock(&pcp->lock);
+			slab = pcp->slab[i];
+			pcp->slab[i] = NULL;
+			spin_unlock(&pcp->lock);
+
+			if (slab)
+				nvkm_ram_slab_retire(ram, slab);
+		}
+	}
+
+	mutex_lock(&ram->mutex);
+	list_for_each_entry_safe(slab, temp, &ram->slab.list, head)
+		nvkm_ram_slab_split(ram, slab);
+	mutex_unlock(&ram->mutex);
+}
+
 static int
 nvkm_vram_kmap(struct nvkm_memory *memory, struct nvkm_memory **pmemory)
 {
@@ -89,6 +442,10 @@ nvkm_vram_dtor(struct nvkm_memory *memory)
 	struct nvkm_mm_node *next = vram->mn;
 	struct nvkm_mm_node *node;
 
+	if (vram->slab) {
+		nvkm_ram_slab_put(vram->ram, vram->slab, vram->mn);
+		kfree(vram->mn);
+	} else
 	if (next) {
 		if (likely(next->nl_entry.next)){
 			mutex_lock(&vram->ram->mutex);
@@ -156,6 +513,7 @@ nvkm_ram_get(struct nvkm_device *device, u8 heap, u8 type, u8 rpage, u64 size,
 	u32 align = (1 << page) >> NVKM_RAM_MM_SHIFT;
 	u32   max = ALIGN(size, 1 << page) >> NVKM_RAM_MM_SHIFT;
 	u32   min = contig ? max : align;
+	bool flushed = false;
 	int ret;
 
 	if (!device->fb || !(ram = device->fb->ram))
@@ -170,6 +528,30 @@ nvkm_ram_get(struct nvkm_device *device, u8 heap, u8 type, u8 rpage, u64 size,
 	vram->page = page;
 	*pmemory = &vram->memory;
 
+	/* Satisfy small allocations from a per-CPU slab if possible. */
+	if (ram->slab.pcp && !back &&
+	    max <= (NVKM_RAM_SLAB_MAX >> NVKM_RAM_MM_SHIFT)) {
+		int idx = nvkm_ram_slab_index(heap, type, page);
+
+		if (idx >= 0) {
+			struct nvkm_mm_node *mn = kzalloc(sizeof(*mn),
+							  GFP_KERNEL);
+			if (!mn) {
+				nvkm_memory_unref(pmemory);
+				return -ENOMEM;
+			}
+
+			vram->slab = nvkm_ram_slab_get(ram, idx, heap, type,
+						       max, align, mn);
+			if (vram->slab) {
+				vram->mn = mn;
+				return 0;
+			}
+
+			kfree(mn);
+		}
+	}
+
 	mutex_lock(&ram->mutex);
 	node = &vram->mn;
 	do {
@@ -177,6 +559,14 @@ nvkm_ram_get(struct nvkm_device *device, u8 heap, u8 type, u8 rpage, u64 size,
 			ret = nvkm_mm_tail(mm, heap, type, max, min, align, &r);
 		else
 			ret = nvkm_mm_head(mm, heap, type, max, min, align, &r);
+		if (ret == -ENOSPC && !flushed && ram->slab.pcp) {
+			/* Memory may be held in partially-used slabs. */
+			mutex_unlock(&ram->mutex);
+			nvkm_ram_slab_flush(ram);
+			flushed = true;
+			mutex_lock(&ram->mutex);
+			continue;
+		}
 		if (ret) {
 			mutex_unlock(&ram->mutex);
 			nvkm_memory_unref(pmemory);
@@ -206,6 +596,11 @@ nvkm_ram_del(struct nvkm_ram **pram)
 	if (ram && !WARN_ON(!ram->func)) {
 		if (ram->func->dtor)
 			*pram = ram->func->dtor(ram);
+		if (ram->slab.pcp) {
+			nvkm_ram_slab_flush(ram);
+			WARN_ON(!list_empty(&ram->slab.list));
+			free_percpu(ram->slab.pcp);
+		}
 		nvkm_mm_fini(&ram->vram);
 		mutex_destroy(&ram->mutex);
 		kfree(*pram);
@@ -234,7 +629,7 @@ nvkm_ram_ctor(const struct nvkm_ram_func *func, struct nvkm_fb *fb,
 		[NVKM_RAM_TYPE_HBM2   ] = "HBM2",
 	};
 	struct nvkm_subdev *subdev = &fb->subdev;
-	int ret;
+	int ret, cpu;
 
 	nvkm_info(subdev, "%d MiB %s\n", (int)(size >> 20), name[type]);
 	ram->func = func;
@@ -243,6 +638,14 @@ nvkm_ram_ctor(const struct nvkm_ram_func *func, struct nvkm_fb *fb,
 	ram->size = size;
 	mutex_init(&ram->mutex);
 
+	INIT_LIST_HEAD(&ram->slab.list);
+	ram->slab.pcp = alloc_percpu(struct nvkm_ram_slab_pcp);
+	if (!ram->slab.pcp)
+		return -ENOMEM;
+
+	for_each_possible_cpu(cpu)
+		spin_lock_init(&per_cpu_ptr(ram->slab.pcp, cpu)->lock);
+
 	if (!nvkm_mm_initialised(&ram->vram)) {
 		ret = nvkm_mm_init(&ram->vram, NVKM_RAM_MM_NORMAL, 0,
 				   size >> NVKM_RAM_MM_SHIFT, 1);
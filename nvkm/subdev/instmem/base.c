@@ -37,8 +37,12 @@ nvkm_instobj_load(struct nvkm_instobj *iobj)
 	int i;
 
 	if (!(map = nvkm_kmap(memory))) {
-		for (i = 0; i < size; i += 4)
-			nvkm_wo32(memory, i, iobj->suspend[i / 4]);
+		if (memory->ptrs->wr) {
+			memory->ptrs->wr(memory, 0, iobj->suspend, size);
+		} else {
+			for (i = 0; i < size; i += 4)
+				nvkm_wo32(memory, i, iobj->suspend[i / 4]);
+		}
 	} else {
 		memcpy_toio(map, iobj->suspend, size);
 	}
@@ -61,8 +65,12 @@ nvkm_instobj_save(struct nvkm_instobj *iobj)
 		return -ENOMEM;
 
 	if (!(map = nvkm_kmap(memory))) {
-		for (i = 0; i < size; i += 4)
-			iobj->suspend[i / 4] = nvkm_ro32(memory, i);
+		if (memory->ptrs->rd) {
+			memory->ptrs->rd(memory, 0, iobj->suspend, size);
+		} else {
+			for (i = 0; i < size; i += 4)
+				iobj->suspend[i / 4] = nvkm_ro32(memory, i);
+		}
 	} else {
 		memcpy_fromio(iobj->suspend, map, size);
 	}
@@ -158,41 +158,70 @@ nv04_instmem_wr32(struct nvkm_instmem *imem, u32 addr, u32 data)
 void
 nv04_instmem_resume(struct nvkm_instmem *imem)
 {
+	struct nvkm_subdev *subdev = &imem->subdev;
 	struct nvkm_instobj *iobj;
+	u64 size = 0;
+	ktime_t time;
 
+	time = ktime_get();
 	list_for_each_entry(iobj, &imem->boot, head) {
-		if (iobj->suspend)
+		if (iobj->suspend) {
+			size += nvkm_memory_size(&iobj->memory);
 			nvkm_instobj_load(iobj);
+		}
 	}
+	nvkm_debug(subdev, "boot objects restored: %llu bytes, %lld us\n",
+		   size, ktime_us_delta(ktime_get(), time));
 
 	nvkm_bar_bar2_init(imem->subdev.device);
 
+	size = 0;
+	time = ktime_get();
 	list_for_each_entry(iobj, &imem->list, head) {
-		if (iobj->suspend)
+		if (iobj->suspend) {
+			size += nvkm_memory_size(&iobj->memory);
 			nvkm_instobj_load(iobj);
+		}
 	}
+	nvkm_debug(subdev, "objects restored: %llu bytes, %lld us\n",
+		   size, ktime_us_delta(ktime_get(), time));
 }
 
 int
 nv04_instmem_suspend(struct nvkm_instmem *imem)
 {
+	struct nvkm_subdev *subdev = &imem->subdev;
 	struct nvkm_instobj *iobj;
+	u64 size = 0;
+	ktime_t time;
 
+	/* Objects that aren't marked for preservation are reconstructed
+	 * by their owners on resume, and don't need to be saved.
+	 */
+	time = ktime_get();
 	list_for_each_entry(iobj, &imem->list, head) {
 		if (iobj->preserve) {
 			int ret = nvkm_instobj_save(iobj);
 			if (ret)
 				return ret;
+			size += nvkm_memory_size(&iobj->memory);
 		}
 	}
+	nvkm_debug(subdev, "objects saved: %llu bytes, %lld us\n",
+		   size, ktime_us_delta(ktime_get(), time));
 
 	nvkm_bar_bar2_fini(imem->subdev.device);
 
+	size = 0;
+	time = ktime_get();
 	list_for_each_entry(iobj, &imem->boot, head) {
 		int ret = nvkm_instobj_save(iobj);
 		if (ret)
 			return ret;
+		size += nvkm_memory_size(&iobj->memory);
 	}
+	nvkm_debug(subdev, "boot objects saved: %llu bytes, %lld us\n",
+		   size, ktime_us_delta(ktime_get(), time));
 
 	return 0;
 }
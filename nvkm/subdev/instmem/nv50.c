@@ -93,10 +93,64 @@ nv50_instobj_rd32_slow(struct nvkm_memory *memory, u64 offset)
 	return data;
 }
 
+/* Bulk PRAMIN access, moving the window (and taking the lock) once per
+ * chunk rather than once per word.  Chunks are kept small (64 accesses)
+ * to bound the time spent with interrupts disabled.
+ */
+#define NV50_INSTOBJ_COPY_CHUNK 256
+
+static void
+nv50_instobj_copy_slow(struct nvkm_memory *memory, u64 offset,
+		       void *data, u32 size, bool write)
+{
+	struct nv50_instobj *iobj = nv50_instobj(memory);
+	struct nv50_instmem *imem = iobj->imem;
+	struct nvkm_device *device = imem->base.subdev.device;
+	unsigned long flags;
+
+	while (size) {
+		u64 base = (nvkm_memory_addr(iobj->ram) + offset) & 0xffffff00000ULL;
+		u64 addr = (nvkm_memory_addr(iobj->ram) + offset) & 0x000000fffffULL;
+		u32 part = min_t(u64, min_t(u32, size, NV50_INSTOBJ_COPY_CHUNK), SZ_1M - addr);
+		void __iomem *pramin = device->pri + 0x700000 + addr;
+
+		spin_lock_irqsave(&imem->base.lock, flags);
+		if (unlikely(imem->addr != base)) {
+			nvkm_wr32(device, 0x001700, base >> 16);
+			imem->addr = base;
+		}
+		if (write)
+			__iowrite32_copy(pramin, data, part / 4);
+		else
+			__ioread32_copy(data, pramin, part / 4);
+		spin_unlock_irqrestore(&imem->base.lock, flags);
+
+		offset += part;
+		data += part;
+		size -= part;
+	}
+}
+
+static void
+nv50_instobj_wr_slow(struct nvkm_memory *memory, u64 offset,
+		     const void *data, u32 size)
+{
+	nv50_instobj_copy_slow(memory, offset, (void *)data, size, true);
+}
+
+static void
+nv50_instobj_rd_slow(struct nvkm_memory *memory, u64 offset,
+		     void *data, u32 size)
+{
+	nv50_instobj_copy_slow(memory, offset, data, size, false);
+}
+
 static const struct nvkm_memory_ptrs
 nv50_instobj_slow = {
 	.rd32 = nv50_instobj_rd32_slow,
 	.wr32 = nv50_instobj_wr32_slow,
+	.rd = nv50_instobj_rd_slow,
+	.wr = nv50_instobj_wr_slow,
 };
 
 static void
@@ -72,9 +72,13 @@ void
 nvkm_mc_reset(struct nvkm_device *device, enum nvkm_subdev_type type, int inst)
 {
 	u64 pmc_enable = nvkm_mc_reset_mask(device, true, type, inst);
+	unsigned long flags;
+
 	if (pmc_enable) {
+		spin_lock_irqsave(&device->mc->lock, flags);
 		device->mc->func->device->disable(device->mc, pmc_enable);
 		device->mc->func->device->enable(device->mc, pmc_enable);
+		spin_unlock_irqrestore(&device->mc->lock, flags);
 	}
 }
 
@@ -82,16 +86,26 @@ void
 nvkm_mc_disable(struct nvkm_device *device, enum nvkm_subdev_type type, int inst)
 {
 	u64 pmc_enable = nvkm_mc_reset_mask(device, false, type, inst);
-	if (pmc_enable)
+	unsigned long flags;
+
+	if (pmc_enable) {
+		spin_lock_irqsave(&device->mc->lock, flags);
 		device->mc->func->device->disable(device->mc, pmc_enable);
+		spin_unlock_irqrestore(&device->mc->lock, flags);
+	}
 }
 
 void
 nvkm_mc_enable(struct nvkm_device *device, enum nvkm_subdev_type type, int inst)
 {
 	u64 pmc_enable = nvkm_mc_reset_mask(device, false, type, inst);
-	if (pmc_enable)
+	unsigned long flags;
+
+	if (pmc_enable) {
+		spin_lock_irqsave(&device->mc->lock, flags);
 		device->mc->func->device->enable(device->mc, pmc_enable);
+		spin_unlock_irqrestore(&device->mc->lock, flags);
+	}
 }
 
 bool
@@ -135,6 +149,7 @@ nvkm_mc_new_(const struct nvkm_mc_func *func, struct nvkm_device *device,
 
 	nvkm_subdev_ctor(&nvkm_mc, device, type, inst, &mc->subdev);
 	mc->func = func;
+	spin_lock_init(&mc->lock);
 
 	if (mc->func->intr) {
 		ret = nvkm_intr_add(mc->func->intr, mc->func->intrs, &mc->subdev,
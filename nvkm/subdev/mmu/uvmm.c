@@ -397,6 +397,7 @@ nvkm_uvmm_mthd_raw_map(struct nvkm_uvmm *uvmm, struct nvif_vmm_raw_v0 *args)
 		.used = true,
 		.mapref = false,
 		.no_comp = true,
+		.no_flush = args->defer,
 	};
 	struct nvkm_memory *memory;
 	void *argv = (void *)(uintptr_t)args->argv;
@@ -442,11 +443,18 @@ nvkm_uvmm_mthd_raw_unmap(struct nvkm_uvmm *uvmm, struct nvif_vmm_raw_v0 *args)
 		return ret;
 
 	nvkm_vmm_raw_unmap(vmm, args->addr, args->size,
-			   args->sparse, refd);
+			   args->sparse, refd, args->defer);
 
 	return 0;
 }
 
+static int
+nvkm_uvmm_mthd_raw_flush(struct nvkm_uvmm *uvmm, struct nvif_vmm_raw_v0 *args)
+{
+	nvkm_vmm_raw_flush(uvmm->vmm);
+	return 0;
+}
+
 static int
 nvkm_uvmm_mthd_raw_sparse(struct nvkm_uvmm *uvmm, struct nvif_vmm_raw_v0 *args)
 {
@@ -483,6 +491,8 @@ nvkm_uvmm_mthd_raw(struct nvkm_uvmm *uvmm, void *argv, u32 argc)
 		return nvkm_uvmm_mthd_raw_unmap(uvmm, &args->v0);
 	case NVIF_VMM_RAW_V0_SPARSE:
 		return nvkm_uvmm_mthd_raw_sparse(uvmm, &args->v0);
+	case NVIF_VMM_RAW_V0_FLUSH:
+		return nvkm_uvmm_mthd_raw_flush(uvmm, &args->v0);
 	default:
 		return -EINVAL;
 	};
@@ -78,6 +78,7 @@ struct nvkm_vmm_iter {
 	u32 pte[NVKM_VMM_LEVELS_MAX];
 	struct nvkm_vmm_pt *pt[NVKM_VMM_LEVELS_MAX];
 	int flush;
+	bool defer;
 };
 
 #ifdef CONFIG_NOUVEAU_DEBUG_MMU
@@ -126,6 +127,15 @@ static inline void
 nvkm_vmm_flush(struct nvkm_vmm_iter *it)
 {
 	if (it->flush != NVKM_VMM_LEVELS_MAX) {
+		/* Caller will invalidate later, via nvkm_vmm_raw_flush(). */
+		if (it->defer) {
+			TRA(it, "flush: %d (deferred)", it->flush);
+			it->vmm->managed.flush = min(it->vmm->managed.flush,
+						     it->flush);
+			it->flush = NVKM_VMM_LEVELS_MAX;
+			return;
+		}
+
 		if (it->vmm->func->flush) {
 			TRA(it, "flush: %d", it->flush);
 			it->vmm->func->flush(it->vmm, it->flush);
@@ -500,6 +510,7 @@ nvkm_vmm_ref_swpt(struct nvkm_vmm_iter *it, struct nvkm_vmm_pt *pgd, u32 pdei)
 static inline u64
 nvkm_vmm_iter(struct nvkm_vmm *vmm, const struct nvkm_vmm_page *page,
 	      u64 addr, u64 size, const char *name, bool ref, bool pfn,
+	      bool defer,
 	      bool (*REF_PTES)(struct nvkm_vmm_iter *, bool pfn, u32, u32),
 	      nvkm_vmm_pte_func MAP_PTES, struct nvkm_vmm_map *map,
 	      nvkm_vmm_pxe_func CLR_PTES)
@@ -513,6 +524,7 @@ nvkm_vmm_iter(struct nvkm_vmm *vmm, const struct nvkm_vmm_page *page,
 	it.vmm = vmm;
 	it.cnt = size >> page->shift;
 	it.flush = NVKM_VMM_LEVELS_MAX;
+	it.defer = defer;
 
 	/* Deconstruct address into PTE indices for each mapping level. */
 	for (it.lvl = 0; desc[it.lvl].bits; it.lvl++) {
@@ -603,6 +615,7 @@ nvkm_vmm_ptes_sparse_put(struct nvkm_vmm *vmm, const struct nvkm_vmm_page *page,
 			 u64 addr, u64 size)
 {
 	nvkm_vmm_iter(vmm, page, addr, size, "sparse unref", false, false,
+		      false,
 		      nvkm_vmm_sparse_unref_ptes, NULL, NULL,
 		      page->desc->func->invalid ?
 		      page->desc->func->invalid : page->desc->func->unmap);
@@ -614,7 +627,8 @@ nvkm_vmm_ptes_sparse_get(struct nvkm_vmm *vmm, const struct nvkm_vmm_page *page,
 {
 	if ((page->type & NVKM_VMM_PAGE_SPARSE)) {
 		u64 fail = nvkm_vmm_iter(vmm, page, addr, size, "sparse ref",
-					 true, false, nvkm_vmm_sparse_ref_ptes,
+					 true, false, false,
+					 nvkm_vmm_sparse_ref_ptes,
 					 NULL, NULL, page->desc->func->sparse);
 		if (fail != ~0ULL) {
 			if ((size = fail - addr))
@@ -678,12 +692,12 @@ nvkm_vmm_ptes_sparse(struct nvkm_vmm *vmm, u64 addr, u64 size, bool ref)
 
 static void
 nvkm_vmm_ptes_unmap(struct nvkm_vmm *vmm, const struct nvkm_vmm_page *page,
-		    u64 addr, u64 size, bool sparse, bool pfn)
+		    u64 addr, u64 size, bool sparse, bool pfn, bool defer)
 {
 	const struct nvkm_vmm_desc_func *func = page->desc->func;
 
 	mutex_lock(&vmm->mutex.map);
-	nvkm_vmm_iter(vmm, page, addr, size, "unmap", false, pfn,
+	nvkm_vmm_iter(vmm, page, addr, size, "unmap", false, pfn, defer,
 		      NULL, NULL, NULL,
 		      sparse ? func->sparse : func->invalid ? func->invalid :
 							      func->unmap);
@@ -693,10 +707,10 @@ nvkm_vmm_ptes_unmap(struct nvkm_vmm *vmm, const struct nvkm_vmm_page *page,
 static void
 nvkm_vmm_ptes_map(struct nvkm_vmm *vmm, const struct nvkm_vmm_page *page,
 		  u64 addr, u64 size, struct nvkm_vmm_map *map,
-		  nvkm_vmm_pte_func func)
+		  nvkm_vmm_pte_func func, bool defer)
 {
 	mutex_lock(&vmm->mutex.map);
-	nvkm_vmm_iter(vmm, page, addr, size, "map", false, false,
+	nvkm_vmm_iter(vmm, page, addr, size, "map", false, false, defer,
 		      NULL, func, map, NULL);
 	mutex_unlock(&vmm->mutex.map);
 }
@@ -706,7 +720,7 @@ nvkm_vmm_ptes_put_locked(struct nvkm_vmm *vmm, const struct nvkm_vmm_page *page,
 			 u64 addr, u64 size)
 {
 	nvkm_vmm_iter(vmm, page, addr, size, "unref", false, false,
-		      nvkm_vmm_unref_ptes, NULL, NULL, NULL);
+		      false, nvkm_vmm_unref_ptes, NULL, NULL, NULL);
 }
 
 static void
@@ -726,7 +740,7 @@ nvkm_vmm_ptes_get(struct nvkm_vmm *vmm, const struct nvkm_vmm_page *page,
 
 	mutex_lock(&vmm->mutex.ref);
 	fail = nvkm_vmm_iter(vmm, page, addr, size, "ref", true, false,
-			     nvkm_vmm_ref_ptes, NULL, NULL, NULL);
+			     false, nvkm_vmm_ref_ptes, NULL, NULL, NULL);
 	if (fail != ~0ULL) {
 		if (fail != addr)
 			nvkm_vmm_ptes_put_locked(vmm, page, addr, fail - addr);
@@ -744,7 +758,7 @@ __nvkm_vmm_ptes_unmap_put(struct nvkm_vmm *vmm, const struct nvkm_vmm_page *page
 	const struct nvkm_vmm_desc_func *func = page->desc->func;
 
 	nvkm_vmm_iter(vmm, page, addr, size, "unmap + unref",
-		      false, pfn, nvkm_vmm_unref_ptes, NULL, NULL,
+		      false, pfn, false, nvkm_vmm_unref_ptes, NULL, NULL,
 		      sparse ? func->sparse : func->invalid ? func->invalid :
 							      func->unmap);
 }
@@ -754,7 +768,7 @@ nvkm_vmm_ptes_unmap_put(struct nvkm_vmm *vmm, const struct nvkm_vmm_page *page,
 			u64 addr, u64 size, bool sparse, bool pfn)
 {
 	if (vmm->managed.raw) {
-		nvkm_vmm_ptes_unmap(vmm, page, addr, size, sparse, pfn);
+		nvkm_vmm_ptes_unmap(vmm, page, addr, size, sparse, pfn, false);
 		nvkm_vmm_ptes_put(vmm, page, addr, size);
 	} else {
 		__nvkm_vmm_ptes_unmap_put(vmm, page, addr, size, sparse, pfn);
@@ -767,7 +781,8 @@ __nvkm_vmm_ptes_get_map(struct nvkm_vmm *vmm, const struct nvkm_vmm_page *page,
 			nvkm_vmm_pte_func func)
 {
 	u64 fail = nvkm_vmm_iter(vmm, page, addr, size, "ref + map", true,
-				 false, nvkm_vmm_ref_ptes, func, map, NULL);
+				 false, false, nvkm_vmm_ref_ptes, func, map,
+				 NULL);
 	if (fail != ~0ULL) {
 		if ((size = fail - addr))
 			nvkm_vmm_ptes_unmap_put(vmm, page, addr, size, false, false);
@@ -788,7 +803,7 @@ nvkm_vmm_ptes_get_map(struct nvkm_vmm *vmm, const struct nvkm_vmm_page *page,
 		if (ret)
 			return ret;
 
-		nvkm_vmm_ptes_map(vmm, page, addr, size, map, func);
+		nvkm_vmm_ptes_map(vmm, page, addr, size, map, func, false);
 
 		return 0;
 	} else {
@@ -1107,6 +1122,7 @@ nvkm_vmm_ctor(const struct nvkm_vmm_func *func, struct nvkm_mmu *mmu,
 	__mutex_init(&vmm->mutex.vmm, "&vmm->mutex.vmm", key ? key : &_key);
 	mutex_init(&vmm->mutex.ref);
 	mutex_init(&vmm->mutex.map);
+	vmm->managed.flush = NVKM_VMM_LEVELS_MAX;
 
 	/* Locate the smallest page size supported by the backend, it will
 	 * have the deepest nesting of page tables.
@@ -1362,7 +1378,7 @@ nvkm_vmm_pfn_map(struct nvkm_vmm *vmm, u8 shift, u64 addr, u64 size, u64 *pfn)
 							    desc->func->pfn);
 			} else {
 				nvkm_vmm_ptes_map(vmm, page, addr, size, &args,
-						  page->desc->func->pfn);
+						  page->desc->func->pfn, false);
 			}
 		} else {
 			if (mapped) {
@@ -1419,7 +1435,8 @@ nvkm_vmm_unmap_locked(struct nvkm_vmm *vmm, struct nvkm_vma *vma, bool pfn)
 		nvkm_vmm_ptes_unmap_put(vmm, page, vma->addr, vma->size, vma->sparse, pfn);
 		vma->refd = NVKM_VMA_PAGE_NONE;
 	} else {
-		nvkm_vmm_ptes_unmap(vmm, page, vma->addr, vma->size, vma->sparse, pfn);
+		nvkm_vmm_ptes_unmap(vmm, page, vma->addr, vma->size, vma->sparse,
+				    pfn, false);
 	}
 
 	nvkm_vmm_unmap_region(vmm, vma);
@@ -1560,7 +1577,8 @@ nvkm_vmm_map_locked(struct nvkm_vmm *vmm, struct nvkm_vma *vma,
 
 		vma->refd = map->page - vmm->func->page;
 	} else {
-		nvkm_vmm_ptes_map(vmm, map->page, vma->addr, vma->size, map, func);
+		nvkm_vmm_ptes_map(vmm, map->page, vma->addr, vma->size, map,
+				  func, vma->no_flush);
 	}
 
 	nvkm_memory_tags_put(vma->memory, vmm->mmu->subdev.device, &vma->tags);
@@ -1851,11 +1869,26 @@ nvkm_vmm_get(struct nvkm_vmm *vmm, u8 page, u64 size, struct nvkm_vma **pvma)
 
 void
 nvkm_vmm_raw_unmap(struct nvkm_vmm *vmm, u64 addr, u64 size,
-		   bool sparse, u8 refd)
+		   bool sparse, u8 refd, bool defer)
 {
 	const struct nvkm_vmm_page *page = &vmm->func->page[refd];
 
-	nvkm_vmm_ptes_unmap(vmm, page, addr, size, sparse, false);
+	nvkm_vmm_ptes_unmap(vmm, page, addr, size, sparse, false, defer);
+}
+
+/* Perform the TLB invalidate for any raw map/unmap requests made with
+ * invalidation deferred since the last flush.
+ */
+void
+nvkm_vmm_raw_flush(struct nvkm_vmm *vmm)
+{
+	mutex_lock(&vmm->mutex.map);
+	if (vmm->managed.flush != NVKM_VMM_LEVELS_MAX) {
+		if (vmm->func->flush)
+			vmm->func->flush(vmm, vmm->managed.flush);
+		vmm->managed.flush = NVKM_VMM_LEVELS_MAX;
+	}
+	mutex_unlock(&vmm->mutex.map);
 }
 
 void
@@ -1935,7 +1968,7 @@ nvkm_vmm_boot(struct nvkm_vmm *vmm)
 		return ret;
 
 	nvkm_vmm_iter(vmm, page, vmm->start, limit, "bootstrap", false, false,
-		      nvkm_vmm_boot_ptes, NULL, NULL, NULL);
+		      false, nvkm_vmm_boot_ptes, NULL, NULL, NULL);
 	vmm->bootstrapped = true;
 	return 0;
 }
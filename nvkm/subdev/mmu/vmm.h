@@ -177,7 +177,8 @@ void nvkm_vmm_unmap_region(struct nvkm_vmm *, struct nvkm_vma *);
 int nvkm_vmm_raw_get(struct nvkm_vmm *vmm, u64 addr, u64 size, u8 refd);
 void nvkm_vmm_raw_put(struct nvkm_vmm *vmm, u64 addr, u64 size, u8 refd);
 void nvkm_vmm_raw_unmap(struct nvkm_vmm *vmm, u64 addr, u64 size,
-			bool sparse, u8 refd);
+			bool sparse, u8 refd, bool defer);
+void nvkm_vmm_raw_flush(struct nvkm_vmm *vmm);
 int nvkm_vmm_raw_sparse(struct nvkm_vmm *, u64 addr, u64 size, bool ref);
 
 static inline bool
@@ -65,37 +65,59 @@ nvkm_timer_read(struct nvkm_timer *tmr)
 	return tmr->func->read(tmr);
 }
 
+static bool
+nvkm_timer_alarm_less(struct rb_node *a, const struct rb_node *b)
+{
+	return rb_entry(a, struct nvkm_alarm, node)->timestamp <
+	       rb_entry(b, struct nvkm_alarm, node)->timestamp;
+}
+
+static void
+nvkm_timer_alarm_remove(struct nvkm_timer *tmr, struct nvkm_alarm *alarm)
+{
+	if (!RB_EMPTY_NODE(&alarm->node)) {
+		rb_erase_cached(&alarm->node, &tmr->alarms);
+		RB_CLEAR_NODE(&alarm->node);
+	}
+}
+
 void
 nvkm_timer_alarm_trigger(struct nvkm_timer *tmr)
 {
 	struct nvkm_alarm *alarm, *atemp;
+	struct rb_node *node;
 	unsigned long flags;
 	LIST_HEAD(exec);
+	u64 time;
 
 	/* Process pending alarms. */
 	spin_lock_irqsave(&tmr->lock, flags);
-	list_for_each_entry_safe(alarm, atemp, &tmr->alarms, head) {
+	time = nvkm_timer_read(tmr);
+	while ((node = rb_first_cached(&tmr->alarms))) {
+		alarm = rb_entry(node, typeof(*alarm), node);
+
 		/* Have we hit the earliest alarm that hasn't gone off? */
-		if (alarm->timestamp > nvkm_timer_read(tmr)) {
+		if (alarm->timestamp > time) {
 			/* Schedule it.  If we didn't race, we're done. */
 			tmr->func->alarm_init(tmr, alarm->timestamp);
-			if (alarm->timestamp > nvkm_timer_read(tmr))
+			time = nvkm_timer_read(tmr);
+			if (alarm->timestamp > time)
 				break;
 		}
 
 		/* Move to completed list.  We'll drop the lock before
 		 * executing the callback so it can reschedule itself.
 		 */
-		list_del_init(&alarm->head);
-		list_add(&alarm->exec, &exec);
+		nvkm_timer_alarm_remove(tmr, alarm);
+		list_add_tail(&alarm->exec, &exec);
 	}
 
 	/* Shut down interrupt if no more pending alarms. */
-	if (list_empty(&tmr->alarms))
+	if (RB_EMPTY_ROOT(&tmr->alarms.rb_root))
 		tmr->func->alarm_fini(tmr);
 	spin_unlock_irqrestore(&tmr->lock, flags);
 
-	/* Execute completed callbacks. */
+	/* Execute completed callbacks, earliest first. */
 	list_for_each_entry_safe(alarm, atemp, &exec, exec) {
 		list_del(&alarm->exec);
 		alarm->func(alarm);
@@ -105,30 +127,23 @@ nvkm_timer_alarm_trigger(struct nvkm_timer *tmr)
 void
 nvkm_timer_alarm(struct nvkm_timer *tmr, u32 nsec, struct nvkm_alarm *alarm)
 {
-	struct nvkm_alarm *list;
 	unsigned long flags;
 
-	/* Remove alarm from pending list.
+	/* Remove alarm from pending tree.
 	 *
-	 * This both protects against the corruption of the list,
+	 * This both protects against the corruption of the tree,
 	 * and implements alarm rescheduling/cancellation.
 	 */
 	spin_lock_irqsave(&tmr->lock, flags);
-	list_del_init(&alarm->head);
+	nvkm_timer_alarm_remove(tmr, alarm);
 
 	if (nsec) {
-		/* Insert into pending list, ordered earliest to latest. */
+		/* Insert into pending tree, ordered earliest to latest. */
 		alarm->timestamp = nvkm_timer_read(tmr) + nsec;
-		list_for_each_entry(list, &tmr->alarms, head) {
-			if (list->timestamp > alarm->timestamp)
-				break;
-		}
-
-		list_add_tail(&alarm->head, &list->head);
+		rb_add_cached(&alarm->node, &tmr->alarms, nvkm_timer_alarm_less);
 
 		/* Update HW if this is now the earliest alarm. */
-		list = list_first_entry(&tmr->alarms, typeof(*list), head);
-		if (list == alarm) {
+		if (rb_first_cached(&tmr->alarms) == &alarm->node) {
 			tmr->func->alarm_init(tmr, alarm->timestamp);
 			/* This shouldn't happen if callers aren't stupid.
 			 *
@@ -192,7 +207,7 @@ nvkm_timer_new_(const struct nvkm_timer_func *func, struct nvkm_device *device,
 
 	nvkm_subdev_ctor(&nvkm_timer, device, type, inst, &tmr->subdev);
 	tmr->func = func;
-	INIT_LIST_HEAD(&tmr->alarms);
+	tmr->alarms = RB_ROOT_CACHED;
 	spin_lock_init(&tmr->lock);
 	return 0;
 }